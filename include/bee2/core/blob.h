@@ -42,6 +42,21 @@ memcpy, memset. Дополнительно по указателю можно о
 например, через файл подкачки. Поэтому в блобах рекомендуется размещать
 ключи и другие критические объекты.
 
+Память для блобов выделяется слотами. В Unix слоты небольшой емкости 
+(до 2 Кб) нарезаются из чанков -- фрагментов памяти из нескольких страниц, 
+остальные слоты состоят из целого числа страниц. Чанки и слоты 
+закрепляются в оперативной памяти и окружаются защитными страницами. 
+Общий объем закрепленной памяти не превосходит меньшего из 32 Мб и 
+ограничения RLIMIT_MEMLOCK. Память сверх этого объема не закрепляется. 
+Если ОС не выделяет память (например, исчерпано число отображений), 
+то слот размещается в куче без закрепления и защитных страниц. Слоты 
+закрытых блобов (после очистки) кэшируются в локальной памяти потока 
+и используются повторно без обращения к системному распределителю памяти.
+Статистику работы с блобами в потоке можно получить с помощью blobStat().
+
+На других платформах (в том числе в Windows) слоты размещаются в куче 
+без закрепления и защитных страниц.
+
 \pre В функциях работы с блобами дескрипторы входных блобов корректны.
 *******************************************************************************
 */
@@ -154,6 +169,38 @@ int blobCmp(
 	const blob_t blob2		/*!< [in] второй блоб */
 );
 
+/*!	\brief Статистика блобов */
+typedef struct
+{
+	size_t allocs;		/*!< число созданных блобов */
+	size_t frees;		/*!< число закрытых блобов */
+	size_t reused;		/*!< число блобов, размещенных в кэшированных слотах */
+	size_t mapped;		/*!< число отображений (чанков и слотов) */
+	size_t unmapped;	/*!< число отображений, возвращенных ОС */
+	size_t unlocked;	/*!< число отображений и слотов в куче, 
+							 не закрепленных в памяти */
+	size_t cached;		/*!< число слотов в кэше */
+	size_t heap;		/*!< число слотов, размещенных в куче */
+} blob_stat_t;
+
+/*!	\brief Статистика блобов потока
+
+	В stat возвращается статистика работы с блобами в вызывающем потоке.
+	\pre Указатель stat корректен.
+	\remark Блоб, созданный в одном потоке и закрытый в другом, учитывается 
+	в поле allocs статистики первого потока и в поле frees статистики 
+	второго.
+	\remark Обращения, выполненные без локальной памяти потоков (она 
+	недоступна или уже освобождена при завершении потока), учитываются 
+	в общей статистике. Эта статистика возвращается, если локальная 
+	память вызывающего потока недоступна.
+	\remark На платформах, отличных от Unix, статистика не ведется: 
+	возвращаются нулевые значения.
+*/
+void blobStat(
+	blob_stat_t* stat		/*!< [out] статистика */
+);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
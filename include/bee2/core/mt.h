@@ -123,9 +123,57 @@ void mtMtxClose(
 
 Управление потоками реализуется по схемам, заданным в новом стандарте
 языка Си ISO/IEC 9899:2011 (см. заголовочный файл threads.h).
+
+Поток запускается функцией mtThrdCreate(). В потоке выполняется функция 
+интерфейса mt_thrd_i. Завершения потока следует дождаться с помощью 
+функции mtThrdJoin().
+
+Если операционная система не распознана, то потоки не создаются: функция
+mtThrdCreate() возвращает FALSE. Вызывающая программа должна быть готова
+выполнить работу потока самостоятельно.
+
+\typedef mt_thrd_t
+\brief Поток
 *******************************************************************************
 */
 
+#ifdef OS_WIN
+	typedef HANDLE mt_thrd_t;
+#elif defined OS_UNIX
+	typedef pthread_t mt_thrd_t;
+#else
+	typedef int mt_thrd_t;
+#endif
+
+/*!	\brief Функция потока
+
+	Выполняется работа потока с аргументом arg.
+*/
+typedef void (*mt_thrd_i)(
+	void* arg			/*!< [in/out] аргумент */
+);
+
+/*!	\brief Создание потока
+
+	Создается поток thrd, в котором выполняется функция start с аргументом arg.
+	\return Признак успеха.
+	\post В случае успеха поток следует закрыть с помощью mtThrdJoin().
+*/
+bool_t mtThrdCreate(
+	mt_thrd_t* thrd,	/*!< [out] поток */
+	mt_thrd_i start,	/*!< [in] функция потока */
+	void* arg			/*!< [in] аргумент */
+);
+
+/*!	\brief Ожидание завершения потока
+
+	Ожидается завершение потока thrd, созданного функцией mtThrdCreate().
+	Ресурсы потока освобождаются.
+*/
+void mtThrdJoin(
+	mt_thrd_t* thrd		/*!< [in] поток */
+);
+
 /*!	\brief Приостановка потока
 
 	Текущий поток приостанавливается на ms миллисекунд.
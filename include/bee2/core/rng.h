@@ -54,11 +54,13 @@ extern "C" {
 	Данные от источника случайности с именем source_name записываются в буфер 
 	[count]buf. По адресу read возвращается число полученных октетов. 
 	Поддерживаются следующие имена источников:
-	-	"trng": аппаратный генератор случайных чисел;
+	-	"trng": аппаратный генератор случайных чисел (команды RDSEED 
+		и RDRAND процессоров Intel, RDRAND используется при отказе RDSEED);
 	-	"timer": высокоточный таймер. Наблюдениями являются разности между 
 		показаниями таймера до и после передачи управления ядру операционной
 		системы;
-	-	"sys": источник операционной системы.
+	-	"sys": источник операционной системы (в Linux -- системный вызов 
+		getrandom(), при его недоступности -- файл /dev/urandom).
 	.
 	\pre Буфер buf корректен.
 	\pre Указатель read корректен.
@@ -156,6 +158,22 @@ bool_t rngTestFIPS4(
 	const octet buf[2500]	/*!< [in] тестируемая последовательность */
 );
 
+/*!	\brief Проверка работоспособности источника
+
+	От источника с именем source_name получается 2500 октетов, к которым 
+	применяются тесты rngTestFIPS1()--rngTestFIPS4(). Если хотя бы один 
+	тест не пройден, то проверка повторяется на новых данных.
+	\return ERR_OK, если тесты пройдены, ERR_BAD_RNG, если тесты не пройдены
+	дважды, ERR_INSUFFICIENT_ENTROPY, если источник выдал меньше 2500 
+	октетов, или код ошибки rngReadSource().
+	\remark Генератор случайных чисел выборочно выполняет проверки 
+	источников при их опросе. Источник, не прошедший проверку, не 
+	используется генератором до следующей успешной проверки.
+*/
+err_t rngTestSource(
+	const char* source_name	/*!< [in] имя источника */
+);
+
 /*!
 *******************************************************************************
 \file rng.h
@@ -173,11 +191,31 @@ bool_t rngTestFIPS4(
 Данные от источников объединяются и хэшируются с помощью механизма
 beltHash (см. crypto/belt.h). Хэш-значение используется как ключ механизма 
 brngCTR (см. crypto/brng.h). При функционировании генератора выполняются 
-последовательные обращения к brngCTR. При подготовке обращений снова 
-используются данные от доступных источников случайности.
+последовательные обращения к brngCTR.
+
+Каждый поток использует собственный экземпляр brngCTR, который хранится 
+в локальной памяти потока. Ключ экземпляра вырабатывается глобальным 
+генератором по данным от доступных источников случайности. Тем самым 
+потоки не конкурируют за глобальный генератор при генерации. Если локальная 
+память потоков недоступна, то используется глобальный генератор.
+
+Источники случайности опрашиваются только при пересеве. Генератор 
+(глобальный или потоковый) пересевается после выработки определенного 
+числа октетов, после определенного числа обращений, по истечении 
+определенного времени (см. rngSetReseed()), а также после повторного 
+создания генератора и после fork().
 *******************************************************************************
 */
 
+/*!	\brief Число октетов до пересева по умолчанию */
+#define RNG_RESEED_OCTETS ((size_t)1 << 20)
+
+/*!	\brief Число обращений до пересева по умолчанию */
+#define RNG_RESEED_CALLS ((size_t)1 << 16)
+
+/*!	\brief Время до пересева по умолчанию (в секундах) */
+#define RNG_RESEED_SECS 60
+
 /*!	\brief Создание генератора
 
 	Создается генератор случайных чисел. При создании используются 
@@ -210,8 +248,11 @@ bool_t rngIsValid();
 	\remark Поддержан интерфейс gen_i (defs.h).
 	\remark Состояние state не используется. Оно передается в функцию
 	только для того, чтобы поддержать интерфейс gen_i.
-	\remark При формировании выходных октетов используются данные от 
-	источников случайности.
+	\remark Источники случайности опрашиваются только при пересеве 
+	генератора.
+	\remark Генерация выполняется с помощью экземпляра вызывающего потока.
+	Глобальный генератор блокируется только при засеве и пересеве 
+	экземпляра.
 */
 void rngStepG(
 	void* buf,				/*!< [out] буфер */
@@ -219,13 +260,107 @@ void rngStepG(
 	void* state				/*!< [in/out] состояние (игнорируется) */
 );
 
+/*!	\brief Политика пересева
+
+	Устанавливается политика пересева генератора: генератор пересевается, 
+	если после последнего засева выработано не менее octets октетов, 
+	выполнено не менее calls обращений или прошло не менее secs секунд.
+	\remark Нулевое значение параметра отключает соответствующий критерий.
+	\remark По умолчанию используются значения RNG_RESEED_OCTETS, 
+	RNG_RESEED_CALLS, RNG_RESEED_SECS.
+	\remark Политику можно устанавливать до создания генератора.
+	Изменение политики вступает в силу при следующем обращении
+	к генератору, но не обязательно сразу во всех потоках.
+*/
+void rngSetReseed(
+	size_t octets,			/*!< [in] число октетов */
+	size_t calls,			/*!< [in] число обращений */
+	size_t secs				/*!< [in] время в секундах */
+);
+
 /*!	\brief Закрытие генератора
 
 	Генератор случайных чисел закрывается.
 	\pre Генератор корректен.
+	\remark При окончательном закрытии освобождается экземпляр 
+	вызывающего потока. Экземпляры других потоков освобождаются при 
+	завершении этих потоков.
 */
 void rngClose();
 
+/*!
+*******************************************************************************
+\file rng.h
+
+\section rng-pool Буферизованный генератор
+
+Буферизованный генератор заранее вырабатывает выходные данные генератора 
+случайных чисел и сохраняет их в кольцевом буфере. Буфер пополняется 
+фоновым потоком. Запросы на генерацию обслуживаются копированием данных 
+из буфера, что снижает задержку обработки небольших запросов (одноразовые 
+ключи, синхропосылки).
+
+Буферизованный генератор является единственным в библиотеке. Его можно
+использовать в многопоточных приложениях.
+
+Фоновый поток простаивающего генератора (буфер заполнен) просыпается 
+с паузами, которые удваиваются до 64 мс. В Unix после fork() буфер 
+дочернего процесса затирается, а фоновый поток перезапускается при 
+первом обращении к генератору.
+
+\safe Прочитанные из буфера данные сразу же затираются и повторно 
+не используются.
+*******************************************************************************
+*/
+
+/*!	\brief Создание буферизованного генератора
+
+	Создается буферизованный генератор с буфером из size октетов 
+	и запускается фоновый поток, пополняющий буфер.
+	\expect{ERR_BAD_INPUT} size > 0.
+	\return ERR_OK в случае успеха и код ошибки в противном случае.
+	\remark Генератор случайных чисел создается с помощью вызова 
+	rngCreate(0, 0) и закрывается при закрытии буферизованного генератора. 
+	Поэтому генератор случайных чисел с дополнительным источником следует 
+	создавать до буферизованного генератора.
+	\remark Повторный вызов функции (без закрытия генератора) только 
+	увеличивает счетчик блокировок. Параметр size при этом игнорируется.
+*/
+err_t rngPoolCreate(
+	size_t size				/*!< [in] размер буфера (в октетах) */
+);
+
+/*!	\brief Корректный буферизованный генератор?
+
+	Проверяется корректность буферизованного генератора.
+	\return Признак корректности.
+*/
+bool_t rngPoolIsValid();
+
+/*!	\brief Буферизованная генерация случайных чисел
+
+	В буфер [count]buf записываются случайные октеты, прочитанные из 
+	буфера генератора. Если в буфере генератора недостаточно данных, 
+	то недостающие октеты вырабатываются функцией rngStepG().
+	\expect rngPoolCreate() < rngPoolStepG()*.
+	\pre Буферизованный генератор корректен.
+	\remark Поддержан интерфейс gen_i (defs.h).
+	\remark Состояние state не используется.
+*/
+void rngPoolStepG(
+	void* buf,				/*!< [out] буфер */
+	size_t count,			/*!< [in] размер буфера (в октетах) */
+	void* state				/*!< [in/out] состояние (игнорируется) */
+);
+
+/*!	\brief Закрытие буферизованного генератора
+
+	Буферизованный генератор закрывается. При окончательном закрытии 
+	фоновый поток останавливается, буфер затирается и освобождается.
+	\pre Буферизованный генератор корректен.
+*/
+void rngPoolClose();
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -24,6 +24,10 @@
 #define BE_COUNT_COVER(r) ((u32) (r * 2 - 1))
 // определение максимального размера в байтах буфера для всех пар индексов множества-покрытия
 #define BE_SIZE_COVER(r, h) ((u32) (r * 2 - 1) * (h/8 + 1))
+// размер в байтах имитовставки
+#define BE_SIZE_IMITO 8
+// размер в байтах синхропосылки
+#define BE_SIZE_SYNHRO 16
 
 /*
     Структуры для алгоритмов 
@@ -54,6 +58,22 @@ err_t beGenUsersKeys(
     u32 *   pCount  /* [out] Количество всех ключей пользователей */
 );
 
+/*
+Функция аналогична beGenUsersKeys, но ключи формируются в threads потоках. 
+Работа распределяется между потоками по внутренним вершинам дерева: 
+ключи C_{i,j} для различных вершин i формируются независимо. Каждый поток 
+использует собственные состояния belt-krp. Результат не зависит от threads. 
+Если потоки не удается создать, то ключи формируются в вызывающем потоке.
+*/
+err_t beGenUsersKeysMT(
+    u8 h, /*[in] Параметр, определяющий количество пользователей n=2^h в системе */
+    u16 m, /*[in] Размер каждого из ключей в системе (в битах): 128, 192 или 256*/
+    u8 *S, /*[in] Ключ центра передачи данных (размера m битов)*/
+    beUserKey *pAKeys, /* [out] Массив всех ключей пользователей */
+    u32 *   pCount,  /* [out] Количество всех ключей пользователей */
+    u32 threads /* [in] Число потоков (больше 0) */
+);
+
 /*
 Функция на основании номера пользователя u выбирает из массива ключей всех 
 пользователей pAKeys ключи для пользователя u (реализует шаг 5 алгоритма 
@@ -72,6 +92,26 @@ err_t beGetUserKeys(
     u32 *pCount /* [out] Количество ключей пользователя u */
 );
 
+/*
+Функция на основании ключа центра передачи S и номера пользователя u 
+вычисляет ключи пользователя u (реализует шаги 1-5 алгоритма формирования 
+ключей пользователей) и сохраняет их по указателю pUKeys. Ключи и их порядок 
+совпадают с теми, которые возвращает функция beGetUserKeys для массива, 
+сформированного функцией beGenUsersKeys. Массив всех ключей не формируется: 
+вычисляются только O(h^2) ключей, связанных с путем из корня в лист u. 
+При этом количество ключей пользователя записывается по указателю pCount. 
+В случае, если pUKeys = NULL функция не выполняет алгоритм, а возвращает 
+в pCount количество ключей для пользователя (при этом S может быть NULL). 
+*/
+err_t beDeriveUserKeys(
+    u8 h, /*[in] Параметр, определяющий количество пользователей n=2^h в системе */
+    u16 m, /*[in] Размер каждого из ключей в системе (в битах): 128, 192 или 256*/
+    u8 *S, /*[in] Ключ центра передачи данных (размера m битов)*/
+    u32 u, /*[in] Номер пользователя (от 1 до 2^h) */
+    beUserKey *pUKeys, /* [out] Массив ключей пользователя u */
+    u32 *pCount /* [out] Количество ключей пользователя u */
+);
+
 /*
 Функция на основании множества запрещенных пользователей R формирует сообщение Х_1 
 протокола широковещательного шифрования (pBX) и записывает по адресу pSize размер 
@@ -132,6 +172,50 @@ u32    beFormAMsgY(
     u32 *pSizeAY /* [out] Размер сформированного сообщения Y (pАY) */
 );
 
+/*
+Потоковое формирование сообщения Y. Сообщение Y является конкатенацией 
+синхропосылки T (BE_SIZE_SYNHRO байтов), зашифрованных данных M и 
+имитовставки (BE_SIZE_IMITO байтов) и совпадает с сообщением, которое 
+формирует beFormAMsgY. Данные M обрабатываются фрагментами произвольной 
+длины: общий объем данных не ограничен 4 Гбайт, объем используемой памяти 
+не зависит от объема данных. Фрагменты зашифровываются на месте, без 
+копирования. Последовательность вызовов: beFormAMsgYStart, 
+beFormAMsgYStep (произвольное число раз), beFormAMsgYFinish.
+Для состояния state следует зарезервировать beAMsgY_keep() байтов.
+*/
+size_t beAMsgY_keep();
+
+/*
+Функция начинает потоковое формирование сообщения Y на сеансовом ключе K 
+с синхропосылкой T. Синхропосылка T передается в начале сообщения Y.
+*/
+err_t beFormAMsgYStart(
+    void *state, /* [out] Состояние */
+    u32 m, /* [in] Размер каждого из ключей в системе (в битах): 128, 192 или 256*/
+    u8 *K, /* [in] Указатель на сеансовый ключ защиты данных (размера m битов) */
+    u8 *T /* [in] Указатель на синхропосылку */
+);
+
+/*
+Функция зашифровывает на месте очередной фрагмент данных M и учитывает 
+его при вычислении имитовставки. Зашифрованный фрагмент является очередным 
+фрагментом сообщения Y.
+*/
+void beFormAMsgYStep(
+    void *buf, /* [in/out] Фрагмент данных M / фрагмент сообщения Y */
+    size_t count, /* [in] Размер фрагмента в байтах */
+    void *state /* [in/out] Состояние */
+);
+
+/*
+Функция завершает потоковое формирование сообщения Y: определяет 
+имитовставку, которая передается в конце сообщения Y.
+*/
+void beFormAMsgYFinish(
+    u8 *pImito, /* [out] Имитовставка (BE_SIZE_IMITO байтов) */
+    void *state /* [in/out] Состояние */
+);
+
 /*
 Функция производит для пользователя u разбор сообщения Х_1 (pBX) протокола и формирует на основании 
 массива ключей пользователей pUKeys ключ снятия защиты pDKey и определяет номер e, 
@@ -201,6 +285,41 @@ err_t beAnalyzAMsgY(
     u32 *pSizeM /* [out] Длина данных, подлежащие широковещательному шифрованию (М)*/
 );
 
+/*
+Функция начинает потоковый разбор сообщения Y на сеансовом ключе K. 
+Синхропосылка T извлекается из начала сообщения Y (первые BE_SIZE_SYNHRO 
+байтов). Для состояния state следует зарезервировать beAMsgY_keep() байтов.
+*/
+err_t beAnalyzAMsgYStart(
+    void *state, /* [out] Состояние */
+    u16 m, /*[in] Размер каждого из ключей в системе (в битах): 128, 192 или 256*/
+    u8 *pK, /* [in] Cеансовый ключ защиты данных (размера m битов) */
+    u8 *T /* [in] Синхропосылка */
+);
+
+/*
+Функция учитывает при проверке имитовставки очередной фрагмент 
+зашифрованных данных сообщения Y и расшифровывает его на месте.
+Расшифрованные данные не следует использовать до успешного завершения 
+функции beAnalyzAMsgYFinish.
+*/
+void beAnalyzAMsgYStep(
+    void *buf, /* [in/out] Фрагмент сообщения Y / фрагмент данных M */
+    size_t count, /* [in] Размер фрагмента в байтах */
+    void *state /* [in/out] Состояние */
+);
+
+/*
+Функция завершает потоковый разбор сообщения Y: проверяет имитовставку, 
+переданную в конце сообщения Y. Если целостность данных не нарушена, 
+то возвращается код ошибки ERR_OK, иначе функция возвращает код ошибки 
+ERR_BAD_MAC.
+*/
+err_t beAnalyzAMsgYFinish(
+    const u8 *pImito, /* [in] Имитовставка (BE_SIZE_IMITO байтов) */
+    void *state /* [in/out] Состояние */
+);
+
 #ifdef __cplusplus
 }
 #endif
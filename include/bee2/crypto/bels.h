@@ -244,6 +244,71 @@ err_t belsRecover(
 	const octet mi[]		/*!< [in] открытые ключи пользователей */
 );
 
+/*!	\brief Пакетное разделение секретов
+
+	Секреты из массива [num * len]s разделяются с порогом threshold на 
+	count частичных секретов каждый. Частичные секреты записываются в массив 
+	[num * count * len]si: частичные секреты j-го секрета образуют j-й блок 
+	из count * len октетов, который устроен так же, как в функции belsShare().
+	Ключи m0, mi, генератор rng и его состояние rng_state используются так же,
+	как в функции belsShare().
+	\expect{ERR_BAD_INPUT}
+	-	len == 16 || len == 24 || len == 32;
+	-	count > 0;
+	-	0 < threshold <= count.
+	.
+	\expect{ERR_BAD_PUBKEY} Открытые ключи m0, mi корректны и отличаются 
+	друг от друга.
+	\expect{ERR_BAD_RNG} Генератор rng (с состоянием rng_state) корректен.
+	\expect Генератор rng является криптографически стойким.
+	\return ERR_OK, если секреты успешно разделены, и код ошибки
+	в противном случае.
+	\remark Вызов belsShareBatch(si, 1, ...) эквивалентен вызову 
+	belsShare(si, ...). Многочлены x^l + mi подготавливаются один раз 
+	для всех секретов.
+*/
+err_t belsShareBatch(
+	octet si[],				/*!< [out] частичные секреты */
+	size_t num,				/*!< [in] число секретов */
+	size_t count,			/*!< [in] число пользователей */
+	size_t threshold,		/*!< [in] пороговое число */
+	size_t len,				/*!< [in] длина секрета в октетах */
+	const octet s[],		/*!< [in] секреты */
+	const octet m0[],		/*!< [in] общий открытый ключ */
+	const octet mi[],		/*!< [in] открытые ключи пользователей */
+	gen_i rng,				/*!< [in] генератор случайных чисел */
+	void* rng_state			/*!< [in/out] состояние генератора */
+);
+
+/*!	\brief Пакетное восстановление секретов
+
+	Секреты восстанавливаются по частичным секретам из массива 
+	[num * count * len]si и записываются в массив [num * len]s. Частичные 
+	секреты j-го секрета образуют j-й блок массива si из count * len октетов,
+	который устроен так же, как в функции belsRecover(). Все секреты 
+	восстанавливаются с помощью одних и тех же ключей m0, mi.
+	\expect{ERR_BAD_INPUT}
+	-	len == 16 || len == 24 || len == 32;
+	-	count > 0.
+	.
+	\expect{ERR_BAD_PUBKEY} Открытые ключи m0, mi корректны и отличаются 
+	друг от друга.
+	\return ERR_OK, если секреты успешно восстановлены, и код ошибки 
+	в противном случае.
+	\remark Коэффициенты интерполяции, которые определяются только ключами 
+	mi, вычисляются один раз и затем используются для всех секретов. 
+	Вызов belsRecoverBatch(s, 1, ...) эквивалентен вызову belsRecover(s, ...).
+*/
+err_t belsRecoverBatch(
+	octet s[],				/*!< [out] восстановленные секреты */
+	size_t num,				/*!< [in] число секретов */
+	size_t count,			/*!< [in] число пользователей */
+	size_t len,				/*!< [in] длина секретов в октетах */
+	const octet si[],		/*!< [in] частичные секреты */
+	const octet m0[],		/*!< [in] общий открытый ключ */
+	const octet mi[]		/*!< [in] открытые ключи пользователей */
+);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
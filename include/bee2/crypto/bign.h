@@ -213,6 +213,66 @@ err_t bignDH(
 	size_t key_len				/*!< [in] длина key в октетах */
 );
 
+/*
+*******************************************************************************
+Сжатие точек
+*******************************************************************************
+*/
+
+/*!	\brief Сжатие точки
+
+	При долговременных параметрах params точка [l / 2]point (например, 
+	открытый ключ) сжимается в точку [l / 4 + 1]xpoint. Сжатая точка 
+	состоит из x-координаты point и октета с четностью y-координаты.
+	\expect{ERR_BAD_PARAMS} Параметры params корректны.
+	\return ERR_OK, если точка сжата, и код ошибки в противном случае.
+	\remark Принадлежность point кривой не проверяется.
+	\remark Буферы point и xpoint могут пересекаться.
+*/
+err_t bignCompressPoint(
+	octet xpoint[],				/*!< [out] сжатая точка */
+	const bign_params* params,	/*!< [in] долговременные параметры */
+	const octet point[]			/*!< [in] сжимаемая точка */
+);
+
+/*!	\brief Восстановление точки
+
+	При долговременных параметрах params точка [l / 2]point 
+	восстанавливается по сжатому представлению [l / 4 + 1]xpoint, 
+	построенному функцией bignCompressPoint().
+	\expect{ERR_BAD_PARAMS} Параметры params корректны.
+	\return ERR_OK, если точка восстановлена, и код ошибки
+	в противном случае. Если по xpoint нельзя построить точку кривой, 
+	то возвращается ERR_BAD_POINT.
+	\remark Квадратный корень вычисляется возведением в степень 
+	(p + 1) / 4 (p \equiv 3 \mod 4).
+	\remark Буферы point и xpoint могут пересекаться.
+*/
+err_t bignRecoverPoint(
+	octet point[],				/*!< [out] восстановленная точка */
+	const bign_params* params,	/*!< [in] долговременные параметры */
+	const octet xpoint[]		/*!< [in] сжатая точка */
+);
+
+/*!	\brief Пакетное восстановление точек
+
+	При долговременных параметрах params точки [count * l / 2]points 
+	восстанавливаются по сжатым представлениям [count * (l / 4 + 1)]xpoints.
+	Результат совпадает с результатом count вызовов функции 
+	bignRecoverPoint().
+	\expect{ERR_BAD_PARAMS} Параметры params корректны.
+	\return ERR_OK, если все точки восстановлены, и код ошибки
+	в противном случае.
+	\remark Описания поля и кривой создаются один раз.
+	\remark При count > 1 буферы points и xpoints не должны пересекаться.
+*/
+err_t bignRecoverPoints(
+	octet points[],				/*!< [out] восстановленные точки */
+	const bign_params* params,	/*!< [in] долговременные параметры */
+	size_t count,				/*!< [in] число точек */
+	const octet xpoints[]		/*!< [in] сжатые точки */
+);
+
 /*
 *******************************************************************************
 Электронная цифровая подпись (ЭЦП)
@@ -330,6 +390,36 @@ err_t bignKeyWrap(
 	void* rng_state				/*!< [in/out] состояние генератора */
 );
 
+/*!	\brief Создание токена ключа на сжатом открытом ключе
+
+	Создается токен [l / 4 + 16 + len]token ключа [len]key с заголовком 
+	[16]header так же, как в функции bignKeyWrap(). Открытый ключ 
+	получателя задается в сжатом представлении [l / 4 + 1]xpubkey, 
+	построенном функцией bignCompressPoint().
+	\expect{ERR_BAD_PARAMS} Параметры params корректны.
+	\expect{ERR_BAD_INPUT} len >= 16.
+	\expect{ERR_BAD_RNG} Генератор rng (с состоянием rng_state) корректен.
+	\expect Используется криптографически стойкий генератор rng.
+	\return ERR_OK, если токен успешно создан, и код ошибки в противном
+	случае. Если по xpubkey нельзя построить точку кривой, то возвращается 
+	ERR_BAD_PUBKEY.
+	\remark Токен содержит только x-координату одноразового открытого ключа 
+	(l / 4 октетов), т.е. уже является сжатым. Разбирается он функцией 
+	bignKeyUnwrap().
+	\remark Четность y-координаты открытого ключа не используется: 
+	x-координаты кратных точек (x, y) и (x, -y) совпадают.
+*/
+err_t bignKeyWrapC(
+	octet token[],				/*!< [out] токен ключа */
+	const bign_params* params,	/*!< [in] долговременные параметры */
+	const octet key[],			/*!< [in] транспортируемый ключ */
+	size_t len,					/*!< [in] длина ключа в октетах */
+	const octet header[16],		/*!< [in] заголовок ключа */
+	const octet xpubkey[],		/*!< [in] сжатый открытый ключ получателя */
+	gen_i rng,					/*!< [in] генератор случайных чисел */
+	void* rng_state				/*!< [in/out] состояние генератора */
+);
+
 /*!	\brief Разбор токена ключа
 
 	Определяется ключ [len - (l / 4 + 16)]key, который имеет заголовок 
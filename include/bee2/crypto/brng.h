@@ -175,6 +175,93 @@ err_t brngCTRRand(
 	octet iv[32]			/*!< [in/out] первонач. / обновл. синхропосылка */
 );
 
+/*
+*******************************************************************************
+Многоэкземплярная генерация в режиме CTR
+
+Механизм предназначен для выработки больших объемов детерминированных 
+псевдослучайных данных. Используется n независимых экземпляров механизма 
+CTR на общем ключе key. Экземпляр i использует синхропосылку 
+iv_i = belt-hash(iv || <i>_32), где <i>_32 -- 4-октетное представление i.
+
+Выходные данные состоят из 32-октетных блоков, которые вырабатываются 
+экземплярами по очереди: блок с номером b (b = 0, 1, ...) вырабатывается 
+экземпляром b mod n. Блоки разных экземпляров можно вырабатывать 
+одновременно. Этой возможностью пользуется функция brngCTRMultiFill(), 
+результат которой не зависит от числа используемых потоков.
+
+\warning Выходные данные механизма отличаются от выходных данных механизма 
+CTR, в том числе при n == 1.
+*******************************************************************************
+*/
+
+/*!	\brief Длина состояния многоэкземплярного режима CTR
+
+	Возвращается длина состояния (в октетах) функций многоэкземплярной 
+	генерации в режиме CTR с n экземплярами.
+	\pre n > 0.
+	\return Длина состояния.
+*/
+size_t brngCTRMulti_keep(
+	size_t n				/*!< [in] число экземпляров */
+);
+
+/*!	\brief Инициализация многоэкземплярного режима CTR
+
+	По ключу key и синхропосылке iv в state формируются структуры данных, 
+	необходимые для генерации псевдослучайных чисел с помощью n экземпляров
+	механизма CTR.
+	\pre n > 0.
+	\pre По адресу state зарезервировано brngCTRMulti_keep(n) октетов.
+	\warning При многократном вызове функции с одним и тем же ключом должны
+	использоваться различные синхропосылки.
+	\remark Разрешается передавать нулевой указатель iv. В этом случае будет 
+	использоваться нулевая синхропосылка.
+*/
+void brngCTRMultiStart(
+	void* state,			/*!< [out] состояние */
+	const octet key[32],	/*!< [in] ключ */
+	const octet iv[32],		/*!< [in] синхропосылка */
+	size_t n				/*!< [in] число экземпляров */
+);
+
+/*!	\brief Генерация фрагмента в многоэкземплярном режиме CTR
+
+	В буфер [count]buf записываются октеты, полученные в результате
+	псевдослучайной генерации в многоэкземплярном режиме CTR. При генерации 
+	используются структуры данных, развернутые в state.
+	\expect brngCTRMultiStart() < brngCTRMultiStepR()*.
+	\remark Первоначальное содержимое очередного блока buf используется 
+	для формирования дополнительного слова X экземпляра, который 
+	вырабатывает этот блок. Как и в brngCTRStepR(), реализована буферизация 
+	блоков.
+*/
+void brngCTRMultiStepR(
+	void* buf,			/*!< [in/out] дополн. / псевдослучайные данные */
+	size_t count,		/*!< [in] число октетов buf */
+	void* state			/*!< [in/out] состояние */
+);
+
+/*!	\brief Параллельная генерация в многоэкземплярном режиме CTR
+
+	В буфер [count]buf записываются те же октеты, что и при вызове
+	brngCTRMultiStepR(buf, count, state). Полные блоки вырабатываются 
+	в threads потоках (но не более чем в n потоках).
+	\expect brngCTRMultiStart() < brngCTRMultiFill()*.
+	\return ERR_OK, если данные успешно сгенерированы, и код ошибки
+	в противном случае.
+	\remark Если поток не удается запустить, то его работа выполняется 
+	в вызывающем потоке.
+	\remark Вызовы brngCTRMultiFill() и brngCTRMultiStepR() можно 
+	чередовать.
+*/
+err_t brngCTRMultiFill(
+	void* buf,			/*!< [in/out] дополн. / псевдослучайные данные */
+	size_t count,		/*!< [in] число октетов buf */
+	void* state,		/*!< [in/out] состояние */
+	size_t threads		/*!< [in] число потоков */
+);
+
 /*
 *******************************************************************************
 Генерация в режиме HMAC (HMAC, алгоритм 6.3.4)
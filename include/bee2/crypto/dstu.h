@@ -202,6 +202,28 @@ err_t dstuRecoverPoint(
 	const octet xpoint[]			/*!< [in] сжатая точка */
 );
 
+/*!	\brief Пакетное восстановление точек
+
+	Точки [2 * count * no]points эллиптической кривой, заданной 
+	долговременными параметрами params, восстанавливаются из сжатых 
+	представлений [count * no]xpoints (no -- длина x-координаты в октетах).
+	Результат совпадает с результатом count вызовов функции 
+	dstuRecoverPoint().
+	\expect{ERR_BAD_PARAMS} Параметры params корректны.
+	\return ERR_OK, если все точки восстановлены, и код ошибки
+	в противном случае.
+	\remark Описания поля и кривой создаются один раз, элементы x^2 
+	обращаются одновременно (метод Монтгомери), полуследы при большом 
+	count рассчитываются по таблицам.
+	\remark Буферы points и xpoints не должны пересекаться.
+*/
+err_t dstuRecoverPoints(
+	octet points[],					/*!< [out] восстановленные точки */
+	const dstu_params* params,		/*!< [in] параметры */
+	size_t count,					/*!< [in] число точек */
+	const octet xpoints[]			/*!< [in] сжатые точки */
+);
+
 /*
 *******************************************************************************
 Управление ключами
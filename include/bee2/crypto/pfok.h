@@ -170,6 +170,22 @@ err_t pfokGenParams(
 	pfok_on_q_i on_q		/*!< [in] обработчик */
 );
 
+/*!	\brief Многопоточная генерация долговременных параметров
+
+	Выполняются те же действия, что и в функции pfokGenParams(), но 
+	простые числа строятся в threads потоках (см. priExtendPrimeMT()).
+	\return ERR_OK, если параметры успешно сгенерированы, и код ошибки
+	в противном случае.
+	\remark Результат не зависит от threads и совпадает с результатом 
+	pfokGenParams().
+*/
+err_t pfokGenParamsMT(
+	pfok_params* params,	/*!< [out] долговременные параметры */
+	const pfok_seed* seed,	/*!< [in] затравочные данные */
+	pfok_on_q_i on_q,		/*!< [in] обработчик */
+	size_t threads			/*!< [in] число потоков */
+);
+
 /*!	\brief Проверка долговременных параметров
 
 	Проверяется, что долговременные параметры params корректны. Для полей 
@@ -243,6 +259,85 @@ err_t pfokCalcPubkey(
 	const octet privkey[]		/*!< [in] личный ключ */
 );
 
+/*
+*******************************************************************************
+Предвычисления
+
+Функции pfokGenKeypair() и pfokCalcPubkey() возводят в степень
+фиксированный образующий g. При многократном построении ключей
+на одних и тех же параметрах следует один раз рассчитать таблицу
+предвычислений для g (функция pfokPrecomp()) и затем использовать функции
+pfokGenKeypairPre() и pfokCalcPubkeyPre(). Эти функции дают те же результаты,
+что и pfokGenKeypair() и pfokCalcPubkey(), но работают в несколько раз
+быстрее.
+
+Таблица предвычислений содержит копию параметров, по которым она
+рассчитана, и не содержит секретных данных.
+*******************************************************************************
+*/
+
+/*!	\brief Длина таблицы предвычислений
+
+	Возвращается длина таблицы предвычислений (в октетах) для параметров
+	с размерностями l и r.
+	\return Длина таблицы.
+*/
+size_t pfokPrecomp_keep(
+	size_t l,					/*!< [in] битовая длина p */
+	size_t r					/*!< [in] битовая длина личного ключа */
+);
+
+/*!	\brief Расчет таблицы предвычислений
+
+	По долговременным параметрам params рассчитывается таблица
+	предвычислений [pfokPrecomp_keep(l, r)]pre для образующего g.
+	\expect{ERR_BAD_PARAMS} Параметры params корректны.
+	\return ERR_OK, если таблица успешно рассчитана, и код ошибки
+	в противном случае.
+*/
+err_t pfokPrecomp(
+	void* pre,					/*!< [out] таблица предвычислений */
+	const pfok_params* params	/*!< [in] долговременные параметры */
+);
+
+/*!	\brief Генерация пары ключей с предвычислениями
+
+	При долговременных параметрах, для которых рассчитана таблица
+	предвычислений pre, генерируются личный [O_OF_B(r)]privkey и
+	открытый [O_OF_B(l)]pubkey ключи. При генерации используется генератор
+	rng и его состояние rng_state.
+	\expect{ERR_BAD_PARAMS} Таблица pre рассчитана функцией pfokPrecomp().
+	\expect{ERR_BAD_RNG} Генератор rng (с состоянием rng_state) корректен.
+	\expect Используется криптографически стойкий генератор rng.
+	\return ERR_OK, если ключи успешно сгенерированы, и код ошибки
+	в противном случае.
+	\remark pubkey = g^(privkey).
+*/
+err_t pfokGenKeypairPre(
+	octet privkey[],			/*!< [out] личный ключ */
+	octet pubkey[],				/*!< [out] открытый ключ */
+	const void* pre,			/*!< [in] таблица предвычислений */
+	gen_i rng,					/*!< [in] генератор случайных чисел */
+	void* rng_state				/*!< [in/out] состояние генератора */
+);
+
+/*!	\brief Построение открытого ключа по личному с предвычислениями
+
+	При долговременных параметрах, для которых рассчитана таблица
+	предвычислений pre, по личному ключу [O_OF_B(r)]privkey строится
+	открытый ключ [O_OF_B(l)]pubkey.
+	\expect{ERR_BAD_PARAMS} Таблица pre рассчитана функцией pfokPrecomp().
+	\expect{ERR_BAD_PRIVKEY} Личный ключ privkey корректен.
+	\return ERR_OK, если открытый ключ успешно построен, и код ошибки
+	в противном случае.
+	\remark pubkey = g^(privkey).
+*/
+err_t pfokCalcPubkeyPre(
+	octet pubkey[],				/*!< [out] открытый ключ */
+	const void* pre,			/*!< [in] таблица предвычислений */
+	const octet privkey[]		/*!< [in] личный ключ */
+);
+
 /*!	\brief Построение общего ключа протокола Диффи -- Хеллмана 
 
 	При долговременных параметрах params по личному ключу 
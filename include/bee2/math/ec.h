@@ -99,7 +99,7 @@ ec->order задается 2 * ec->f->n + 1 машинным словом. Ко
 криптографические вычисления на эллиптической кривой. 
 
 Описание ec эллиптической кривой включает указатели на функции арифметики 
-в группе точек этой кривой. Функцию интерфейса ec_tpl_i
+в группе точек этой кривой. Функции интерфейсов ec_tpl_i, ec_mula_i
 можно не поддерживать. Указатель на неподдерживаемую функцию 
 должен быть нулевым.
 
@@ -353,6 +353,33 @@ typedef void (*ec_tpl_i)(
 	void* stack				/*!< [in] вспомогательная память */
 );
 
+/*!	\brief Кратная точка
+
+	Определяется аффинная точка [2 * ec->f->n]b эллиптической кривой ec, 
+	которая является [m]d-кратной аффинной точки [2 * ec->f->n]a:
+	\code
+		b <- d a.
+	\endcode
+	Функция интерфейса реализует специализированный для кривой алгоритм 
+	кратной точки, который используется в ecMulA() вместо общего.
+	\pre Описание ec работоспособно.
+	\pre Буфер b либо не пересекается, либо совпадает с буфером a.
+	\pre Координаты a лежат в базовом поле.
+	\expect Описание ec корректно.
+	\expect Точка a лежит на кривой.
+	\return TRUE, если кратная точка является аффинной, и FALSE в противном
+	случае (b == O).
+	\remark Глубина стека функции интерфейса не должна превосходить ec->deep.
+*/
+typedef bool_t (*ec_mula_i)(
+	word b[],				/*!< [out] кратная точка */
+	const word a[],			/*!< [in] базовая точка */
+	const struct ec_o* ec,	/*!< [in] описание эллиптической кривой */
+	const word d[],			/*!< [in] кратность */
+	size_t m,				/*!< [in] длина d в машинных словах */
+	void* stack				/*!< [in] вспомогательная память */
+);
+
 /*!	\brief Описание эллиптической кривой
 
 	Описывается эллиптическая кривая, правила представления ее элементов, 
@@ -383,6 +410,7 @@ typedef struct ec_o
 	ec_dbl_i dbl;			/*!< функция удвоения */
 	ec_dbla_i dbla;			/*!< функция удвоения аффинной точки */
 	ec_tpl_i tpl;			/*!< функция утроения */
+	ec_mula_i mula;			/*!< функция кратной точки */
 	size_t deep;			/*!< максимальная глубина стека функций */
 	octet descr[];			/*!< память для размещения данных */
 } ec_o;
@@ -556,6 +584,8 @@ bool_t ecIsOperableGroup(
 	\expect Точка a лежит на ec.
 	\return TRUE, если кратная точка является аффинной, и FALSE в противном
 	случае (b == O).
+	\remark Если в описании ec задана функция ec->mula, то кратная точка 
+	определяется с ее помощью.
 	\deep{stack} ecpMulA_deep(ec->f->n, ec->d, ec->f->deep, m).
 */
 bool_t ecMulA(
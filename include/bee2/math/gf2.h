@@ -58,7 +58,7 @@ extern "C" {
 
 Массив p, описывающий p(x), при создании поля фиксируется  
 по адресу params (см. описание типа qr_o). При создании поля 
-также формируется модуль mod. Модуль представляется либо n 
+также формируется маска следа (см. gf2Tr()) и модуль mod. Модуль представляется либо n 
 машинными словами (степень p(x) кратна B_PER_W), либо n + 1 словом 
 (степень p(x) не кратна B_PER_W).  
 
@@ -198,6 +198,8 @@ qr_sub_i, qr_neg_i идут прямые обращения к wwXor(), wwXor2()
 	\pre Элемент a принадлежит f.
 	\expect Описание f корректно.
 	\return FALSE, если след равняется 0, и TRUE, если след равняется 1.
+	\remark След рассчитывается за O(f->n) операций с помощью маски, 
+	построенной при создании поля.
 	\deep{stack} gf2Tr_deep(f->n, f->deep).
 */
 bool_t gf2Tr(
@@ -234,6 +236,77 @@ bool_t gf2QSolve(
 
 size_t gf2QSolve_deep(size_t n, size_t f_deep);
 
+/*!	\brief Предвычисления для расчета полуследа
+
+	В поле f = GF(2^m) рассчитываются таблицы pre, которые затем 
+	используются для быстрого вычисления полуследа
+	\code
+		\htr(a) <- \sum {i = 0}^{(m - 1) / 2} a^{4^i}.
+	\endcode
+	\pre Описание f работоспособно.
+	\pre m -- нечетное.
+	\expect Описание f корректно.
+	\keep{pre} gf2HTrPre_keep(m).
+	\deep{stack} gf2HTrPre_deep(f->n, f->deep).
+	\remark Расчет таблиц требует O(m^2) возведений в квадрат. Таблицы 
+	имеет смысл строить, если предстоит вычислить много полуследов, 
+	например, при восстановлении большого числа сжатых точек.
+*/
+void gf2HTrPre(
+	word pre[],				/*!< [out] таблицы */
+	const qr_o* f,			/*!< [in] описание поля */
+	void* stack				/*!< [in] вспомогательная память */
+);
+
+size_t gf2HTrPre_keep(size_t m);
+size_t gf2HTrPre_deep(size_t n, size_t f_deep);
+
+/*!	\brief Полуслед элемента поля GF(2^m)
+
+	В поле f = GF(2^m) с помощью таблиц pre определяется полуслед [f->n]b
+	элемента [f->n]a:
+	\code
+		b <- \htr(a).
+	\endcode
+	\pre Описание f работоспособно.
+	\pre m -- нечетное.
+	\pre Таблицы pre построены с помощью gf2HTrPre().
+	\pre Буфер b не пересекается с буфером a.
+	\pre Элемент a принадлежит f.
+	\expect Описание f корректно.
+	\remark Если \tr(a) == 0, то b -- решение уравнения x^2 + x == a.
+	\deep{stack} gf2HTr_deep(f->n).
+*/
+void gf2HTr(
+	word b[],				/*!< [out] полуслед */
+	const word a[],			/*!< [in] элемент */
+	const word pre[],		/*!< [in] таблицы */
+	const qr_o* f,			/*!< [in] описание поля */
+	void* stack				/*!< [in] вспомогательная память */
+);
+
+size_t gf2HTr_deep(size_t n);
+
+/*!	\brief Решение квадратного уравнения с предвычислениями
+
+	Решается квадратное уравнение так же, как в функции gf2QSolve(). 
+	Полуслед рассчитывается с помощью таблиц pre.
+	\pre Таблицы pre построены с помощью gf2HTrPre().
+	\pre Выполнены условия gf2QSolve().
+	\return TRUE, если решение есть, и FALSE в противном случае.
+	\deep{stack} gf2QSolvePre_deep(f->n, f->deep).
+*/
+bool_t gf2QSolvePre(
+	word x[],					/*!< [out] решение */
+	const word a[],				/*!< [in] коэффициент a */
+	const word b[],				/*!< [in] коэффициент b */
+	const word pre[],			/*!< [in] таблицы */
+	const qr_o* f,				/*!< [in] описание поля */
+	void* stack					/*!< [in] вспомогательная память */
+);
+
+size_t gf2QSolvePre_deep(size_t n, size_t f_deep);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
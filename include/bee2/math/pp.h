@@ -129,6 +129,9 @@ size_t ppAddMulW_deep(size_t n);
 		c <- a * b.
 	\endcode
 	\pre Буфер c не пересекается с буферами a и b.
+	\remark Если n != m, то более длинный множитель разбивается на блоки, 
+	длина которых равняется длине другого множителя, и блоки умножаются 
+	по алгоритму Карацубы.
 	\deep{stack} ppMul_deep(n, m).
 */
 void ppMul(
@@ -250,6 +253,8 @@ size_t ppGCD_deep(size_t n, size_t m);
 	\endcode
 	(коэффициенты Безу).
 	\pre a != 0 && b != 0.
+	\pre b / x^s не делится на x, где x^s -- максимальная степень x, 
+	на которую делятся и a, и b (например, b не делится на x).
 	\pre Буферы d, da, db не пересекаются между собой и с буферами a, b.
 	\deep{stack} ppExGCD_deep(n, m).
 */
@@ -274,6 +274,10 @@ size_t priNextPrime_deep(size_t n, size_t base_count);
 	\remark Для применения теоремы Демитко требуется выполнение условия 
 	2 * r < 4 * q + 1. Ограничение l <= 2 * wwBitSize(q, n) гарантирует
 	выполнение этого условия.
+	\remark Результат не зависит от base_count: составные p не проходят 
+	проверку условия теоремы Демитко. Увеличение base_count уменьшает 
+	число проверок по теореме Демитко, но увеличивает глубину стека 
+	(на 3 * base_count машинных слов).
 	\deep{stack} priExtendPrime_deep(l, n, base_count).
 */
 
@@ -291,6 +295,37 @@ bool_t priExtendPrime(
 
 size_t priExtendPrime_deep(size_t l, size_t n, size_t base_count);
 
+/*!	\brief Многопоточное расширение простого
+
+	Выполняются те же действия, что и в функции priExtendPrime(), но 
+	проверка кандидатов p по теореме Демитко распределяется между threads 
+	потоками. 
+	\pre Выполнены предусловия priExtendPrime().
+	\pre threads > 0.
+	\return TRUE, если искомое простое найдено, и FALSE в противном случае.
+	\remark Результат не зависит от threads: при одинаковых состояниях rng
+	функции priExtendPrime() и priExtendPrimeMT() строят одно и то же p.
+	\remark Память для стеков дополнительных потоков выделяется в куче. 
+	Если память выделить не удалось или потоки не поддерживаются, то 
+	проверка выполняется в одном потоке.
+	\deep{stack} priExtendPrimeMT_deep(l, n, base_count, threads).
+*/
+bool_t priExtendPrimeMT(
+	word p[],			/*!< [out] расширенное простое число */
+	size_t l,			/*!< [in] длина p в битах */
+	const word q[],		/*!< [in] базовое простое число */
+	size_t n,			/*!< [in] длина q в машинных словах */
+	size_t trials,		/*!< [in] число кандидатов */
+	size_t base_count,	/*!< [in] число элементов факторной базы */
+	gen_i rng,			/*!< [in] генератор случайных чисел */
+	void* rng_state,	/*!< [in] состояние rng */
+	size_t threads,		/*!< [in] число потоков */
+	void* stack			/*!< [in] вспомогательная память */
+);
+
+size_t priExtendPrimeMT_deep(size_t l, size_t n, size_t base_count, 
+	size_t threads);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
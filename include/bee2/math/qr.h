@@ -446,6 +446,107 @@ void qrPower(
 
 size_t qrPower_deep(size_t n, size_t m, size_t r_deep);
 
+/*! \brief Произведение степеней в кольце вычетов
+
+	В кольце вычетов r определяется элемент [r->n]c, который является
+	произведением [m[i]]b[i]-ых степеней элементов [r->n]a[i], i = 1,..., k:
+	\code
+		c <- a[1]^b[1] * a[2]^b[2] * ... * a[k]^b[k].
+	\endcode
+	Тройки a[i], b[i], m[i] передаются как дополнительные параметры
+	типов const word[], const word[], size_t соответственно.
+	\pre Описание кольца r работоспособно.
+	\pre k > 0.
+	\pre Элементы a[1], a[2],..., a[k] принадлежат r.
+	\expect Описание кольца r корректно.
+	\remark Если b[1] == ... == b[k] == 0, то возвращается r->unity.
+	\deep{stack} qrPowerMulti_deep(r->n, r->deep, k, m[1], ..., m[k]).
+*/
+void qrPowerMulti(
+	word c[],				/*!< [out] произведение степеней */
+	const qr_o* r,			/*!< [in] описание кольца */
+	void* stack,			/*!< [in] вспомогательная память */
+	size_t k,				/*!< [in] число троек (a[i], b[i], m[i]) */
+	...						/*!< [in] тройки (a[i], b[i], m[i]) */
+);
+
+size_t qrPowerMulti_deep(size_t n, size_t r_deep, size_t k, ...);
+
+/*! \brief Предвычисления для возведения в степень с фиксированным основанием
+
+	В кольце вычетов r для элемента [r->n]a и показателей длины m машинных
+	слов рассчитывается таблица pre гребенчатого метода Лима -- Ли.
+	Таблица используется затем в функции qrPowerComb().
+	\pre Описание кольца r работоспособно.
+	\pre Элемент a принадлежит r.
+	\pre Буфер pre имеет длину qrPowerCombPre_keep(r->n, m) октетов.
+	\expect Описание кольца r корректно.
+	\remark Таблица зависит только от a, m и r. Ее имеет смысл рассчитать
+	один раз и использовать при многократном возведении a в степень.
+	\deep{stack} qrPowerCombPre_deep(r->n, m, r->deep).
+*/
+void qrPowerCombPre(
+	word pre[],				/*!< [out] таблица предвычислений */
+	const word a[],			/*!< [in] основание */
+	size_t m,				/*!< [in] длина показателей в машинных словах */
+	const qr_o* r,			/*!< [in] описание кольца */
+	void* stack				/*!< [in] вспомогательная память */
+);
+
+size_t qrPowerCombPre_keep(size_t n, size_t m);
+size_t qrPowerCombPre_deep(size_t n, size_t m, size_t r_deep);
+
+/*! \brief Возведение в степень с фиксированным основанием
+
+	В кольце вычетов r определяется элемент [r->n]c, который является [m]b-ой
+	степенью элемента a, для которого ранее рассчитана таблица pre:
+	\code
+		c <- a^b.
+	\endcode
+	\pre Описание кольца r работоспособно.
+	\pre Таблица pre рассчитана функцией qrPowerCombPre() для элемента a,
+	длины m и кольца r.
+	\expect Описание кольца r корректно.
+	\remark При b == 0 возвращается r->unity.
+	\deep{stack} qrPowerComb_deep(r->n, m, r->deep).
+*/
+void qrPowerComb(
+	word c[],				/*!< [out] степень */
+	const word pre[],		/*!< [in] таблица предвычислений */
+	const word b[],			/*!< [in] показатель */
+	size_t m,				/*!< [in] длина b в машинных словах */
+	const qr_o* r,			/*!< [in] описание кольца */
+	void* stack				/*!< [in] вспомогательная память */
+);
+
+size_t qrPowerComb_deep(size_t n, size_t m, size_t r_deep);
+
+/*! \brief Пакетное обращение в кольце вычетов
+
+	В кольце вычетов r определяются элементы [count * r->n]b, обратные к 
+	элементам [count * r->n]a:
+	\code
+		b[i] <- a[i]^{-1}, i = 0, 1,..., count - 1.
+	\endcode
+	\pre Описание кольца r работоспособно.
+	\pre count > 0.
+	\pre Элементы a[i] принадлежат r и обратимы.
+	\pre Буферы a и b не пересекаются.
+	\expect Описание кольца r корректно.
+	\remark Реализован метод Монтгомери: вместо count обращений 
+	выполняется одно обращение и 3 * (count - 1) умножений.
+	\deep{stack} qrInvBatch_deep(r->n, r->deep).
+*/
+void qrInvBatch(
+	word b[],				/*!< [out] обратные элементы */
+	const word a[],			/*!< [in] обращаемые элементы */
+	size_t count,			/*!< [in] число элементов */
+	const qr_o* r,			/*!< [in] описание кольца */
+	void* stack				/*!< [in] вспомогательная память */
+);
+
+size_t qrInvBatch_deep(size_t n, size_t r_deep);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
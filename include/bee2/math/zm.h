@@ -69,6 +69,15 @@ c <- a * b * R^{-1} \mod mod,
 
 \remark Функции zzCreateMont() и zzMontCreate() создают разные кольца.
 
+В кольце с редукцией Крэндалла (mod = B^n - c) допускается избыточное 
+представление элементов: любое число a \in [0, B^n) представляет вычет 
+a \mod mod. Функции умножения и возведения в квадрат такого кольца принимают 
+элементы в избыточном представлении и возвращают вычеты. Аддитивные операции 
+в избыточном представлении выполняются функциями zzAddModCrand(), 
+zzSubModCrand(), zzDoubleModCrand(), zzHalfModCrand(), нормализация -- 
+функцией zzNormCrand(). Проверить, что кольцо построено с редукцией 
+Крэндалла, можно с помощью функции zmIsCrand().
+
 \pre Все указатели действительны.
 
 \safe todo
@@ -238,6 +247,19 @@ bool_t zmIsValid(
 
 #define zmIsOperable zmIsValid
 
+/*!	\brief Кольцо с редукцией Крэндалла?
+
+	Проверяется, что описание r кольца вычетов целых чисел построено 
+	функцией zmCreateCrand() (непосредственно или через zmCreate()).
+	\pre Описание r работоспособно.
+	\return Признак кольца с редукцией Крэндалла.
+	\remark В кольце с редукцией Крэндалла можно использовать избыточное 
+	представление элементов.
+*/
+bool_t zmIsCrand(
+	const qr_o* r		/*!< [in] описание кольца */
+);
+
 /*
 *******************************************************************************
 Акселераторы
@@ -1006,6 +1006,134 @@ void zzRedCrand(
 
 size_t zzRedCrand_deep(size_t n);
 
+/*!	\brief Сложение в избыточном представлении Крэндалла
+
+	Определяется число [n]c, сравнимое с суммой чисел [n]a и [n]b по модулю 
+	[n]mod:
+	\code
+		с \equiv a + b \mod mod.
+	\endcode
+	Число c не обязательно меньше mod, но обязательно меньше B^n.
+	\pre n >= 2 && mod[n - 1] != 0.
+	\pre Модуль mod имеет вид B^n - c, где 0 < c < B^n / 2.
+	\pre Буфер c либо не пересекается, либо совпадает с каждым из буферов a, b.
+	\pre Буфер с не пересекается с буфером mod.
+	\remark Условие a, b < mod не требуется: числа a и b могут быть 
+	произвольными n-словными (избыточное представление вычетов).
+	\safe todo
+*/
+void zzAddModCrand(
+	word c[],			/*!< [out] сумма */
+	const word a[],		/*!< [in] первое слагаемое */
+	const word b[],		/*!< [in] второе слагаемое */
+	const word mod[],	/*!< [in] модуль Крэндалла */
+	size_t n			/*!< [in] длина чисел в машинных словах */
+);
+
+/*!	\brief Вычитание в избыточном представлении Крэндалла
+
+	Определяется число [n]c, сравнимое с разностью чисел [n]a и [n]b 
+	по модулю [n]mod:
+	\code
+		с \equiv a - b \mod mod.
+	\endcode
+	Число c не обязательно меньше mod, но обязательно меньше B^n.
+	\pre n >= 2 && mod[n - 1] != 0.
+	\pre Модуль mod имеет вид B^n - c, где 0 < c < B^n / 2.
+	\pre Буфер c либо не пересекается, либо совпадает с каждым из буферов a, b.
+	\pre Буфер с не пересекается с буфером mod.
+	\remark Числа a и b могут быть произвольными n-словными.
+	\safe todo
+*/
+void zzSubModCrand(
+	word c[],			/*!< [out] разность */
+	const word a[],		/*!< [in] уменьшаемое */
+	const word b[],		/*!< [in] вычитаемое */
+	const word mod[],	/*!< [in] модуль Крэндалла */
+	size_t n			/*!< [in] длина чисел в машинных словах */
+);
+
+/*!	\brief Аддитивное обращение в избыточном представлении Крэндалла
+
+	Определяется число [n]b, сравнимое с -a по модулю [n]mod:
+	\code
+		b \equiv -a \mod mod.
+	\endcode
+	Число b не обязательно меньше mod, но обязательно меньше B^n.
+	\pre n >= 2 && mod[n - 1] != 0.
+	\pre Модуль mod имеет вид B^n - c, где 0 < c < B^n / 2.
+	\pre Буфер b либо не пересекается, либо совпадает с буфером a.
+	\pre Буфер b не пересекается с буфером mod.
+	\remark Число a может быть произвольным n-словным.
+	\safe todo
+*/
+void zzNegModCrand(
+	word b[],			/*!< [out] обратное число */
+	const word a[],		/*!< [in] число */
+	const word mod[],	/*!< [in] модуль Крэндалла */
+	size_t n			/*!< [in] длина чисел в машинных словах */
+);
+
+/*!	\brief Удвоение в избыточном представлении Крэндалла
+
+	Определяется число [n]b, сравнимое с 2 * a по модулю [n]mod:
+	\code
+		b \equiv 2 * a \mod mod.
+	\endcode
+	Число b не обязательно меньше mod, но обязательно меньше B^n.
+	\pre n >= 2 && mod[n - 1] != 0.
+	\pre Модуль mod имеет вид B^n - c, где 0 < c < B^n / 2.
+	\pre Буфер b либо не пересекается, либо совпадает с буфером a.
+	\pre Буфер b не пересекается с буфером mod.
+	\remark Число a может быть произвольным n-словным.
+	\safe todo
+*/
+void zzDoubleModCrand(
+	word b[],			/*!< [out] произведение */
+	const word a[],		/*!< [in] множитель */
+	const word mod[],	/*!< [in] модуль Крэндалла */
+	size_t n			/*!< [in] длина чисел в машинных словах */
+);
+
+/*!	\brief Половина в избыточном представлении Крэндалла
+
+	Определяется число [n]b, сравнимое с a * 2^{-1} по модулю [n]mod:
+	\code
+		b \equiv a * 2^{-1} \mod mod.
+	\endcode
+	Число b не обязательно меньше mod, но обязательно меньше B^n.
+	\pre n >= 2 && mod[n - 1] != 0.
+	\pre Модуль mod -- нечетный и имеет вид B^n - c, где 0 < c < B^n / 2.
+	\pre Буфер b либо не пересекается, либо совпадает с буфером a.
+	\pre Буфер b не пересекается с буфером mod.
+	\remark Число a может быть произвольным n-словным.
+	\safe todo
+*/
+void zzHalfModCrand(
+	word b[],			/*!< [out] частное */
+	const word a[],		/*!< [in] делимое */
+	const word mod[],	/*!< [in] модуль Крэндалла */
+	size_t n			/*!< [in] длина чисел в машинных словах */
+);
+
+/*!	\brief Нормализация избыточного представления Крэндалла
+
+	Число [n]a из избыточного представления заменяется на свой вычет 
+	по модулю [n]mod:
+	\code
+		a <- a \mod mod.
+	\endcode
+	\pre n >= 2 && mod[n - 1] != 0.
+	\pre Модуль mod имеет вид B^n - c, где 0 < c < B^n / 2.
+	\pre Буфер a не пересекается с буфером mod.
+	\safe todo
+*/
+void zzNormCrand(
+	word a[],			/*!< [in/out] число / вычет */
+	const word mod[],	/*!< [in] модуль Крэндалла */
+	size_t n			/*!< [in] длина чисел в машинных словах */
+);
+
 /*!	\brief Параметр Барретта
 
 	По модулю [n]mod определяется параметр [n + 2]barr_param:
@@ -1130,6 +1258,35 @@ void zzPowerMod(
 
 size_t zzPowerMod_deep(size_t n, size_t m);
 
+/*!	\brief Произведение степеней по модулю
+
+	Определяется число [n]c, которое является произведением [m]b-ой степени
+	числа [n]a и [m1]b1-ой степени числа [n]a1 по модулю [n]mod:
+	\code
+		c <- a^b a1^b1 \mod mod.
+	\endcode
+	\pre n > 0 && mod[n - 1] != 0.
+	\pre a, a1 < mod.
+	\remark Возведения в квадрат выполняются для обеих степеней одновременно
+	(см. qrPowerMulti()).
+	\deep{stack} zzPowerMod2_deep(n, m, m1).
+	\safe todo
+*/
+void zzPowerMod2(
+	word c[],				/*!< [out] произведение степеней */
+	const word a[],			/*!< [in] первое основание */
+	const word b[],			/*!< [in] первый показатель */
+	size_t m,				/*!< [in] длина b в машинных словах */
+	const word a1[],		/*!< [in] второе основание */
+	const word b1[],		/*!< [in] второй показатель */
+	size_t m1,				/*!< [in] длина b1 в машинных словах */
+	size_t n,				/*!< [in] длина a, a1, mod в машинных словах */
+	const word mod[],		/*!< [in] модуль */
+	void* stack				/*!< [in] вспомогательная память */
+);
+
+size_t zzPowerMod2_deep(size_t n, size_t m, size_t m1);
+
 /*!	\brief Возведение в степень по модулю машинного слова
 
 	Определяется b-ая степень числа a по модулю машинного слова mod.
@@ -19,56 +19,561 @@ version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
 Блоб: реализация
 
-В куче выделяется память под указатель ptr. Память выделяется страницами.
-
-Первые sizeof(size_t) октетов по адресу ptr --- размер блоба,
+Блоб размещается в слоте -- фрагменте памяти емкости cap. Первые 
+sizeof(size_t) октетов слота -- его емкость (в октетах) и флаги 
+(в младших битах), следующие sizeof(size_t) октетов --- размер блоба, 
 следующие октеты --- собственно блоб.
 
-\todo Обеспечить защиту памяти блоба от утечек.
+Емкость слотов выбирается из классов. Малые классы: 64, 128, ..., 2048 
+октетов. Страничные классы: 1, 2, 4, ..., 16 страниц ОС. Слоты большей 
+емкости (из целого числа страниц) классов не имеют.
+
+В Unix слоты малых классов нарезаются из чанков -- фрагментов памяти 
+по BLOB_CHUNK_PAGES страниц, каждый чанк содержит слоты одного класса. 
+Свободные слоты малых классов хранятся в общих списках _free, защищенных 
+мьютексом _mtx. Чанки ОС не возвращаются: их число ограничено пиковым 
+числом одновременно открытых малых блобов. Остальные слоты выделяются 
+по одному. Чанки и слоты страничных классов выделяются с помощью mmap() 
+и окружаются защитными страницами (PROT_NONE), обращение к которым 
+приводит к аварийному завершению. Между слотами внутри чанка защитных 
+страниц нет. Таким образом, тысячи малых блобов занимают единицы 
+отображений и не исчерпывают vm.max_map_count.
+
+Память чанков и слотов закрепляется (mlock()) и, если это возможно, 
+исключается из дампов памяти (MADV_DONTDUMP). Общий объем закрепленной 
+памяти (_locked) ограничен бюджетом _lock_max, который равняется 
+min(BLOB_LOCK_MAX, RLIMIT_MEMLOCK). Память сверх бюджета не закрепляется. 
+После первой неудачи mlock() бюджет уменьшается до уже закрепленного 
+объема: дальнейшие попытки закрепления бессмысленны. Незакрепленные 
+фрагменты учитываются в статистике (поле unlocked).
+
+Если mmap() завершается с ошибкой (например, исчерпан vm.max_map_count), 
+то слот выделяется в куче: без защитных страниц и закрепления. Такие 
+слоты учитываются в статистике (поля heap и unlocked).
+
+При закрытии блоба его октеты затираются, а слот помещается в кэш 
+вызывающего потока (не более BLOB_CACHE_MAX слотов каждого класса). 
+При создании блоба слот подходящего класса берется из кэша, и только 
+при пустом кэше -- из общего списка (малые классы) или у ОС. Кэш 
+размещается в локальной памяти потока и освобождается при завершении 
+потока. Слот может быть освобожден в потоке, отличном от того, в котором 
+он был выделен: слот попадает в кэш освобождающего потока или (слот 
+малого класса) в общий список. На время fork() мьютекс _mtx блокируется, 
+чтобы дочерний процесс не унаследовал его заблокированным.
+
+После освобождения кэша в ключе локальной памяти сохраняется признак 
+_cache_closed. Блобы, которые закрываются позже в деструкторах других 
+ключей (например, экземпляры rng), освобождаются без кэша, новый кэш 
+не создается. Признак восстанавливается при каждом повторном вызове 
+деструктора, пока система повторяет вызовы (не более 
+PTHREAD_DESTRUCTOR_ITERATIONS раз).
+
+Если кэш недоступен, то статистика ведется в общей структуре _stat 
+под мьютексом _mtx.
+
+На других платформах (в том числе в Windows) слоты выделяются в куче 
+страницами по BLOB_PAGE_SIZE октетов и не кэшируются. Память не 
+закрепляется, защитных страниц нет. Статистика не ведется.
+
+\todo Закрепление и защитные страницы в Windows (VirtualLock(), 
+VirtualProtect()).
 
 \todo Полноценная проверка корректности блоба.
 *******************************************************************************
 */
 
+// число малых классов емкости
+#define BLOB_SMALL_COUNT 6
+
+// емкость слотов наименьшего класса
+#define BLOB_SMALL_MIN 64
+
+// число страничных классов емкости
+#define BLOB_PAGE_COUNT 5
+
+// число классов емкости
+#define BLOB_CLASS_COUNT (BLOB_SMALL_COUNT + BLOB_PAGE_COUNT)
+
+// число страниц в чанке
+#define BLOB_CHUNK_PAGES 16
+
+// максимальное число слотов каждого класса в кэше потока
+#define BLOB_CACHE_MAX 8
+
+// максимальный объем закрепленной памяти
+#define BLOB_LOCK_MAX ((size_t)32 << 20)
+
+// флаги слота: слот чанка, слот в куче, слот закреплен
+#define BLOB_SLOT_CHUNK 1
+#define BLOB_SLOT_HEAP 2
+#define BLOB_SLOT_LOCKED 4
+#define BLOB_SLOT_FLAGS 7
+
+// длина заголовка слота
+#define blobHdrSize (2 * sizeof(size_t))
+
+// слот для блоба
+#define blobPtrOf(blob) ((size_t*)(blob) - 2)
+
+// емкость слота
+#define blobSlotCap(ptr) ((ptr)[0] & ~(size_t)BLOB_SLOT_FLAGS)
+
+// емкость слота блоба
+#define blobCapOf(blob) blobSlotCap(blobPtrOf(blob))
+
+// размер блоба
+#define blobSizeOf(blob) (blobPtrOf(blob)[1])
+
+// блоб для слота
+#define blobValueOf(ptr) ((blob_t)((size_t*)(ptr) + 2))
+
+#if defined OS_UNIX
+
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#ifndef MAP_ANONYMOUS
+	#define MAP_ANONYMOUS MAP_ANON
+#endif
+
+typedef struct
+{
+	size_t* slots[BLOB_CLASS_COUNT];	/*< списки свободных слотов */
+	size_t counts[BLOB_CLASS_COUNT];	/*< длины списков */
+	blob_stat_t stat;					/*< статистика */
+} blob_cache_st;
+
+static size_t _page;				/*< размер страницы */
+static pthread_key_t _key;			/*< ключ локальной памяти */
+static pthread_once_t _once = PTHREAD_ONCE_INIT;
+static bool_t _key_ok;				/*< ключ создан */
+static blob_stat_t _stat;			/*< статистика (без кэша) */
+static octet _cache_closed;			/*< признак освобожденного кэша */
+static pthread_mutex_t _mtx = PTHREAD_MUTEX_INITIALIZER;
+static size_t* _free[BLOB_SMALL_COUNT];	/*< свободные слоты чанков */
+static size_t _locked;				/*< объем закрепленной памяти */
+static size_t _lock_max;			/*< бюджет закрепления */
+
+static size_t blobPageSize()
+{
+	if (!_page)
+	{
+		long page = sysconf(_SC_PAGESIZE);
+		_page = page > 0 ? (size_t)page : 4096;
+	}
+	return _page;
+}
+
+static size_t blobCapFor(size_t size)
+{
+	size_t page = blobPageSize();
+	size_t pages;
+	size_t cap;
+	// малый класс?
+	if (size + blobHdrSize <= (size_t)BLOB_SMALL_MIN << (BLOB_SMALL_COUNT - 1))
+	{
+		for (cap = BLOB_SMALL_MIN; cap < size + blobHdrSize; cap <<= 1);
+		return cap;
+	}
+	// страничный класс?
+	pages = (size + blobHdrSize + page - 1) / page;
+	if (pages > (size_t)1 << (BLOB_PAGE_COUNT - 1))
+		return pages * page;
+	for (cap = 1; cap < pages; cap <<= 1);
+	return cap * page;
+}
+
+static size_t blobClassOf(size_t cap)
+{
+	size_t page = blobPageSize();
+	size_t k;
+	for (k = 0; k < BLOB_SMALL_COUNT; ++k)
+		if (cap == (size_t)BLOB_SMALL_MIN << k)
+			return k;
+	for (k = 0; k < BLOB_PAGE_COUNT; ++k)
+		if (cap == page << k)
+			return BLOB_SMALL_COUNT + k;
+	return BLOB_CLASS_COUNT;
+}
+
+/*
+*******************************************************************************
+Отображения
+
+Функция blobMap() выделяет фрагмент памяти размера size (кратен размеру 
+страницы), окруженный защитными страницами. Функция blobLock() закрепляет 
+фрагмент в пределах бюджета.
+*******************************************************************************
+*/
+
+static octet* blobMap(size_t size, blob_stat_t* stat)
+{
+	size_t page = blobPageSize();
+	octet* map;
+	map = (octet*)mmap(0, size + 2 * page, PROT_NONE, 
+		MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (map == (octet*)MAP_FAILED)
+		return 0;
+	if (mprotect(map + page, size, PROT_READ | PROT_WRITE) != 0)
+	{
+		munmap(map, size + 2 * page);
+		return 0;
+	}
+#ifdef MADV_DONTDUMP
+	madvise(map + page, size, MADV_DONTDUMP);
+#endif
+	++stat->mapped;
+	return map + page;
+}
+
+static void blobUnmap(octet* ptr, size_t size, blob_stat_t* stat)
+{
+	size_t page = blobPageSize();
+	munmap(ptr - page, size + 2 * page);
+	++stat->unmapped;
+}
+
+static bool_t blobLock(octet* ptr, size_t size, blob_stat_t* stat)
+{
+	bool_t ret = FALSE;
+	pthread_mutex_lock(&_mtx);
+	if (_locked + size <= _lock_max)
+	{
+		if (mlock(ptr, size) == 0)
+			_locked += size, ret = TRUE;
+		else
+			_lock_max = _locked;
+	}
+	pthread_mutex_unlock(&_mtx);
+	if (!ret)
+		++stat->unlocked;
+	return ret;
+}
+
+static void blobUnlock(octet* ptr, size_t size)
+{
+	munlock(ptr, size);
+	pthread_mutex_lock(&_mtx);
+	_locked -= size;
+	pthread_mutex_unlock(&_mtx);
+}
+
+/*
+*******************************************************************************
+Чанки
+
+Функция blobChunkPop() берет слот класса k < BLOB_SMALL_COUNT из общего 
+списка. Если список пуст, то выделяется и нарезается новый чанк (вне 
+мьютекса _mtx). Функция blobChunkPush() возвращает слот в общий список.
+*******************************************************************************
+*/
+
+static size_t* blobChunkPop(size_t k, blob_stat_t* stat)
+{
+	size_t* ptr;
+	pthread_mutex_lock(&_mtx);
+	if (!_free[k])
+	{
+		const size_t cap = (size_t)BLOB_SMALL_MIN << k;
+		const size_t size = BLOB_CHUNK_PAGES * blobPageSize();
+		size_t flags = BLOB_SLOT_CHUNK;
+		octet* chunk;
+		size_t* tail;
+		size_t pos;
+		pthread_mutex_unlock(&_mtx);
+		// выделить чанк
+		if ((chunk = blobMap(size, stat)) == 0)
+			return 0;
+		if (blobLock(chunk, size, stat))
+			flags |= BLOB_SLOT_LOCKED;
+		// нарезать слоты
+		for (pos = 0; pos < size; pos += cap)
+		{
+			ptr = (size_t*)(chunk + pos);
+			ptr[0] = cap | flags;
+			ptr[1] = pos + cap < size ? (size_t)(chunk + pos + cap) : 0;
+		}
+		tail = (size_t*)(chunk + (size / cap - 1) * cap);
+		// присоединить слоты к общему списку
+		pthread_mutex_lock(&_mtx);
+		tail[1] = (size_t)_free[k];
+		_free[k] = (size_t*)chunk;
+	}
+	ptr = _free[k];
+	_free[k] = (size_t*)ptr[1];
+	pthread_mutex_unlock(&_mtx);
+	return ptr;
+}
+
+static void blobChunkPush(size_t* ptr)
+{
+	size_t k = blobClassOf(blobSlotCap(ptr));
+	ASSERT(k < BLOB_SMALL_COUNT);
+	pthread_mutex_lock(&_mtx);
+	ptr[1] = (size_t)_free[k];
+	_free[k] = ptr;
+	pthread_mutex_unlock(&_mtx);
+}
+
+/*
+*******************************************************************************
+Слоты
+*******************************************************************************
+*/
+
+static size_t* blobSlotAlloc(size_t cap, blob_stat_t* stat)
+{
+	size_t k = blobClassOf(cap);
+	size_t* ptr;
+	// слот чанка
+	if (k < BLOB_SMALL_COUNT)
+	{
+		if ((ptr = blobChunkPop(k, stat)) != 0)
+			return ptr;
+	}
+	// отдельный слот
+	else if ((ptr = (size_t*)blobMap(cap, stat)) != 0)
+	{
+		ptr[0] = cap;
+		if (blobLock((octet*)ptr, cap, stat))
+			ptr[0] |= BLOB_SLOT_LOCKED;
+		return ptr;
+	}
+	// слот в куче
+	if ((ptr = (size_t*)memAlloc(cap)) == 0)
+		return 0;
+	++stat->heap, ++stat->unlocked;
+	ptr[0] = cap | BLOB_SLOT_HEAP;
+	return ptr;
+}
+
+static void blobSlotFree(size_t* ptr, blob_stat_t* stat)
+{
+	size_t cap = blobSlotCap(ptr);
+	if (ptr[0] & BLOB_SLOT_CHUNK)
+		blobChunkPush(ptr);
+	else if (ptr[0] & BLOB_SLOT_HEAP)
+		memFree(ptr);
+	else
+	{
+		if (ptr[0] & BLOB_SLOT_LOCKED)
+			blobUnlock((octet*)ptr, cap);
+		blobUnmap((octet*)ptr, cap, stat);
+	}
+}
+
+/*
+*******************************************************************************
+Кэш потока
+*******************************************************************************
+*/
+
+static void blobCacheClose(void* arg)
+{
+	blob_cache_st* cache = (blob_cache_st*)arg;
+	size_t k;
+	// кэш уже освобожден?
+	if (arg == &_cache_closed)
+	{
+		pthread_setspecific(_key, &_cache_closed);
+		return;
+	}
+	for (k = 0; k < BLOB_CLASS_COUNT; ++k)
+		while (cache->slots[k])
+		{
+			size_t* ptr = cache->slots[k];
+			cache->slots[k] = (size_t*)ptr[1];
+			blobSlotFree(ptr, &cache->stat);
+		}
+	memFree(cache);
+	pthread_setspecific(_key, &_cache_closed);
+}
+
+static void blobForkPrepare()
+{
+	pthread_mutex_lock(&_mtx);
+}
+
+static void blobForkParent()
+{
+	pthread_mutex_unlock(&_mtx);
+}
+
+static void blobKeyCreate()
+{
+	struct rlimit rl;
+	// бюджет закрепления
+	_lock_max = BLOB_LOCK_MAX;
+	if (getrlimit(RLIMIT_MEMLOCK, &rl) == 0 && rl.rlim_cur != RLIM_INFINITY &&
+		rl.rlim_cur < (rlim_t)_lock_max)
+		_lock_max = (size_t)rl.rlim_cur;
+	// обработчики fork()
+	pthread_atfork(blobForkPrepare, blobForkParent, blobForkParent);
+	// ключ локальной памяти
+	_key_ok = pthread_key_create(&_key, blobCacheClose) == 0;
+}
+
+static blob_cache_st* blobCacheGet()
+{
+	blob_cache_st* cache;
+	pthread_once(&_once, blobKeyCreate);
+	if (!_key_ok)
+		return 0;
+	cache = (blob_cache_st*)pthread_getspecific(_key);
+	if (cache == (void*)&_cache_closed)
+		return 0;
+	if (cache)
+		return cache;
+	cache = (blob_cache_st*)memAlloc(sizeof(blob_cache_st));
+	if (cache == 0)
+		return 0;
+	memSetZero(cache, sizeof(blob_cache_st));
+	if (pthread_setspecific(_key, cache) != 0)
+	{
+		memFree(cache);
+		return 0;
+	}
+	return cache;
+}
+
+static size_t* blobCachePop(blob_cache_st* cache, size_t cap)
+{
+	size_t k = blobClassOf(cap);
+	size_t* ptr;
+	if (!cache || k == BLOB_CLASS_COUNT || !cache->slots[k])
+		return 0;
+	ptr = cache->slots[k];
+	cache->slots[k] = (size_t*)ptr[1];
+	--cache->counts[k], --cache->stat.cached, ++cache->stat.reused;
+	return ptr;
+}
+
+static bool_t blobCachePush(blob_cache_st* cache, size_t* ptr)
+{
+	size_t k = blobClassOf(blobSlotCap(ptr));
+	if (!cache || k == BLOB_CLASS_COUNT || cache->counts[k] >= BLOB_CACHE_MAX)
+		return FALSE;
+	ptr[1] = (size_t)cache->slots[k];
+	cache->slots[k] = ptr;
+	++cache->counts[k], ++cache->stat.cached;
+	return TRUE;
+}
+
+static void blobStatAdd(const blob_stat_t* stat)
+{
+	pthread_mutex_lock(&_mtx);
+	_stat.allocs += stat->allocs;
+	_stat.frees += stat->frees;
+	_stat.reused += stat->reused;
+	_stat.mapped += stat->mapped;
+	_stat.unmapped += stat->unmapped;
+	_stat.unlocked += stat->unlocked;
+	_stat.cached += stat->cached;
+	_stat.heap += stat->heap;
+	pthread_mutex_unlock(&_mtx);
+}
+
+static void blobStatGet(blob_stat_t* stat)
+{
+	pthread_mutex_lock(&_mtx);
+	memCopy(stat, &_stat, sizeof(blob_stat_t));
+	pthread_mutex_unlock(&_mtx);
+}
+
+#else
+
 // память для блобов выделяется страницами
 #define BLOB_PAGE_SIZE 1024
 
-// требуется страниц
-#define blobPageCount(size)\
-	(((size) + sizeof(size_t) + BLOB_PAGE_SIZE - 1) / BLOB_PAGE_SIZE)
+typedef struct
+{
+	blob_stat_t stat;			/*< статистика */
+} blob_cache_st;
 
-// требуется памяти на страницах
-#define blobActualSize(size)\
-	(blobPageCount(size) * BLOB_PAGE_SIZE)
+static size_t blobCapFor(size_t size)
+{
+	return (size + blobHdrSize + BLOB_PAGE_SIZE - 1) / BLOB_PAGE_SIZE * 
+		BLOB_PAGE_SIZE;
+}
 
-// heap-указатель для блоба
-#define blobPtrOf(blob) ((size_t*)blob - 1)
+static size_t* blobSlotAlloc(size_t cap, blob_stat_t* stat)
+{
+	size_t* ptr = (size_t*)memAlloc(cap);
+	if (ptr == 0)
+		return 0;
+	++stat->heap, ++stat->unlocked;
+	ptr[0] = cap | BLOB_SLOT_HEAP;
+	return ptr;
+}
 
-// размер блоба
-#define blobSizeOf(blob) (*blobPtrOf(blob))
+static void blobSlotFree(size_t* ptr, blob_stat_t* stat)
+{
+	memFree(ptr);
+}
 
-// страничный размер блоба
-#define blobActualSizeOf(blob) (blobActualSize(blobSizeOf(blob)))
+static blob_cache_st* blobCacheGet()
+{
+	return 0;
+}
 
-// блоб для heap-указателя
-#define blobValueOf(ptr) ((blob_t)((size_t*)ptr + 1))
+static size_t* blobCachePop(blob_cache_st* cache, size_t cap)
+{
+	return 0;
+}
+
+static bool_t blobCachePush(blob_cache_st* cache, size_t* ptr)
+{
+	return FALSE;
+}
+
+static void blobStatAdd(const blob_stat_t* stat)
+{
+}
+
+static void blobStatGet(blob_stat_t* stat)
+{
+	memSetZero(stat, sizeof(blob_stat_t));
+}
+
+#endif
 
 blob_t blobCreate(size_t size)
 {
+	blob_cache_st* cache;
+	blob_stat_t* stat;
+	blob_stat_t stat1[1];
+	size_t cap;
 	size_t* ptr;
-	if (size == 0)
+	if (size == 0 || size > SIZE_MAX / 2)
 		return 0;
-	ptr = (size_t*)memAlloc(blobActualSize(size));
+	cache = blobCacheGet();
+	if (cache)
+		stat = &cache->stat;
+	else
+		memSetZero(stat = stat1, sizeof(blob_stat_t));
+	cap = blobCapFor(size);
+	ptr = blobCachePop(cache, cap);
 	if (ptr == 0)
-		return 0;
-	*ptr = size;
-	memSetZero(blobValueOf(ptr), size);
-	return blobValueOf(ptr);
+		ptr = blobSlotAlloc(cap, stat);
+	if (ptr != 0)
+	{
+		ptr[1] = size;
+		memSetZero(blobValueOf(ptr), size);
+		++stat->allocs;
+	}
+	if (!cache)
+		blobStatAdd(stat);
+	return ptr ? blobValueOf(ptr) : 0;
 }
 
 bool_t blobIsValid(const blob_t blob)
 {
-	return blob == 0 || memIsValid(blobPtrOf(blob), blobActualSizeOf(blob));
+	return blob == 0 || 
+		memIsValid(blobPtrOf(blob), blobHdrSize) &&
+		blobSizeOf(blob) <= blobCapOf(blob) - blobHdrSize &&
+		memIsValid(blobPtrOf(blob), blobCapOf(blob));
 }
 
 void blobWipe(blob_t blob)
@@ -83,15 +588,28 @@ void blobClose(blob_t blob)
 	ASSERT(blobIsValid(blob));
 	if (blob)
 	{
-		memWipe(blobPtrOf(blob), blobActualSizeOf(blob));
-		memFree(blobPtrOf(blob));
+		blob_cache_st* cache = blobCacheGet();
+		blob_stat_t* stat;
+		blob_stat_t stat1[1];
+		size_t* ptr = blobPtrOf(blob);
+		if (cache)
+			stat = &cache->stat;
+		else
+			memSetZero(stat = stat1, sizeof(blob_stat_t));
+		memWipe(blob, blobSizeOf(blob));
+		ptr[1] = 0;
+		++stat->frees;
+		if (!blobCachePush(cache, ptr))
+			blobSlotFree(ptr, stat);
+		if (!cache)
+			blobStatAdd(stat);
 	}
 }
 
 blob_t blobResize(blob_t blob, size_t size)
 {
 	size_t old_size;
-	size_t* ptr;
+	blob_t blob1;
 	// pre
 	ASSERT(blobIsValid(blob));
 	// создать блоб
@@ -105,20 +623,33 @@ blob_t blobResize(blob_t blob, size_t size)
 	}
 	// сохранить размер
 	old_size = blobSizeOf(blob);
-	// перераспределить память?
-	ptr = blobPtrOf(blob);
-	if (blobActualSizeOf(blob) != blobActualSize(size))
+	// слот вмещает новый блоб?
+	if (size <= blobCapOf(blob) - blobHdrSize)
 	{
-		ptr = (size_t*)memRealloc(ptr, blobActualSize(size));
-		if (ptr == 0)
-			return 0;
+		if (size > old_size)
+			memSetZero((octet*)blob + old_size, size - old_size);
+		else
+			memWipe((octet*)blob + size, old_size - size);
+		blobSizeOf(blob) = size;
+		return blob;
 	}
-	// настроить и возвратить блоб
-	*ptr = size;
-	blob = blobValueOf(ptr);
-	if (size > old_size)
-		memSetZero((octet*)blob + old_size, size - old_size);
-	return blob;
+	// перенести блоб в новый слот
+	blob1 = blobCreate(size);
+	if (blob1 == 0)
+		return 0;
+	memCopy(blob1, blob, old_size);
+	blobClose(blob);
+	return blob1;
+}
+
+void blobStat(blob_stat_t* stat)
+{
+	blob_cache_st* cache = blobCacheGet();
+	ASSERT(memIsValid(stat, sizeof(blob_stat_t)));
+	if (cache)
+		memCopy(stat, &cache->stat, sizeof(blob_stat_t));
+	else
+		blobStatGet(stat);
 }
 
 size_t blobSize(const blob_t blob)
@@ -11,6 +11,7 @@ version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
 */
 
+#include "bee2/core/blob.h"
 #include "bee2/core/mem.h"
 #include "bee2/core/mt.h"
 #include "bee2/core/util.h"
@@ -147,3 +148,99 @@ void mtSleep(u32 ms)
 
 #endif // OS
 
+/*
+*******************************************************************************
+Запуск потоков
+
+Функция потока и ее аргумент передаются в системную функцию потока через 
+блоб, который освобождается в начале работы потока.
+*******************************************************************************
+*/
+
+typedef struct
+{
+	mt_thrd_i start;	/*!< функция потока */
+	void* arg;			/*!< аргумент */
+} mt_thrd_st;
+
+#ifdef OS_WIN
+
+static DWORD WINAPI mtThrdMain(LPVOID arg)
+{
+	mt_thrd_st st = *(mt_thrd_st*)arg;
+	blobClose(arg);
+	st.start(st.arg);
+	return 0;
+}
+
+bool_t mtThrdCreate(mt_thrd_t* thrd, mt_thrd_i start, void* arg)
+{
+	mt_thrd_st* st;
+	ASSERT(memIsValid(thrd, sizeof(mt_thrd_t)));
+	ASSERT(start != 0);
+	st = (mt_thrd_st*)blobCreate(sizeof(mt_thrd_st));
+	if (st == 0)
+		return FALSE;
+	st->start = start, st->arg = arg;
+	*thrd = CreateThread(0, 0, mtThrdMain, st, 0, 0);
+	if (*thrd == NULL)
+	{
+		blobClose(st);
+		return FALSE;
+	}
+	return TRUE;
+}
+
+void mtThrdJoin(mt_thrd_t* thrd)
+{
+	ASSERT(memIsValid(thrd, sizeof(mt_thrd_t)));
+	WaitForSingleObject(*thrd, INFINITE);
+	CloseHandle(*thrd);
+}
+
+#elif defined OS_UNIX
+
+static void* mtThrdMain(void* arg)
+{
+	mt_thrd_st st = *(mt_thrd_st*)arg;
+	blobClose(arg);
+	st.start(st.arg);
+	return 0;
+}
+
+bool_t mtThrdCreate(mt_thrd_t* thrd, mt_thrd_i start, void* arg)
+{
+	mt_thrd_st* st;
+	ASSERT(memIsValid(thrd, sizeof(mt_thrd_t)));
+	ASSERT(start != 0);
+	st = (mt_thrd_st*)blobCreate(sizeof(mt_thrd_st));
+	if (st == 0)
+		return FALSE;
+	st->start = start, st->arg = arg;
+	if (pthread_create(thrd, 0, mtThrdMain, st) != 0)
+	{
+		blobClose(st);
+		return FALSE;
+	}
+	return TRUE;
+}
+
+void mtThrdJoin(mt_thrd_t* thrd)
+{
+	ASSERT(memIsValid(thrd, sizeof(mt_thrd_t)));
+	pthread_join(*thrd, 0);
+}
+
+#else
+
+bool_t mtThrdCreate(mt_thrd_t* thrd, mt_thrd_i start, void* arg)
+{
+	return FALSE;
+}
+
+void mtThrdJoin(mt_thrd_t* thrd)
+{
+}
+
+#endif // OS
+
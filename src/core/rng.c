@@ -29,105 +29,156 @@ version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
 Физический источник
 
-Поддержан ГСЧ Intel
+Поддержан ГСЧ Intel: команды RDSEED (энтропийный источник) и RDRAND 
+(криптографическая постобработка данных источника).
+
+Для получения очередного слова сначала вызывается RDSEED (если команда 
+поддерживается), а при ее неудаче -- RDRAND. Каждая команда повторяется 
+не более RNG_RDSEED_RETRIES / RNG_RDRAND_RETRIES раз. Если обе команды 
+не выдали данных, то генерация прекращается.
+
+Признаки поддержки команд определяются один раз и сохраняются.
 
 Реализация:
 -	по материалам https://software.intel.com/en-us/articles/
 	intel-digital-random-number-generator-drng-software-implementation-guide.
 
-\todo Протестировать.
-
-\todo Используется rdrand (криптографическая постобработка), 
-хотя можно попробовать и rdseed.
+\todo Протестировать на платформе MSVC.
 *******************************************************************************
 */
 
+#define RNG_RDSEED_RETRIES 100
+#define RNG_RDRAND_RETRIES 10
+
 #if	defined(_MSC_VER) && defined(_M_IX86)
 
 #pragma intrinsic(__cpuid)
 
-static bool_t rngHasTRNG()
+static void rngCPUID(u32 info[4], u32 leaf)
 {
-	u32 info[4];
-	// Intel?
-	__cpuid((int*)info, 0);
-	if (!memEq(info + 1, "Genu", 4) ||
-		!memEq(info + 3, "ineI", 4) ||
-		!memEq(info + 2, "ntel", 4))
-		return FALSE;
-	/* rdrand? */
-	__cpuid((int*)info, 1);
-	 return (info[2] & 0x40000000) == 0x40000000;
+	__cpuid((int*)info, (int)leaf);
 }
 
 #define rdrand_eax	__asm _emit 0x0F __asm _emit 0xC7 __asm _emit 0xF0
+#define rdseed_eax	__asm _emit 0x0F __asm _emit 0xC7 __asm _emit 0xF8
 
-static err_t rngReadTRNG(size_t* read, void* buf, size_t count)
+static bool_t rngRDRand(word* rand)
 {
-	word* rand = (word*)buf;
-	size_t i;
-	// pre
-	ASSERT(memIsValid(read, sizeof(size_t)));
-	ASSERT(memIsValid(buf, count));
-	// есть источник?
-	if (!rngHasTRNG())
-		return ERR_FILE_NOT_FOUND;
-	// короткий буфер?
-	if (count < O_PER_W)
-	{
-		*read = 0;
-		return ERR_OK;
+	octet ok = 0;
+	__asm {
+		xor eax, eax
+		rdrand_eax
+		jnc rngRDRand_fail
+		mov edx, rand
+		mov [edx], eax
+		mov ok, 1
+	rngRDRand_fail:
 	}
-	// генерация
-	for (i = 0; i < count; i += O_PER_W, ++rand)
-	{
-		if (i + O_PER_W > count)
-		{
-			i -= count - O_PER_W;
-			rand = (word*)((octet*)buf + i);
-		}
-		__asm {
-			xor eax, eax
-			xor edx, edx
-			rdrand_eax
-			jnc rngSeedTRNG_break
-			mov edx, rand
-			mov [edx], eax
-		}
+	return ok;
+}
+
+static bool_t rngRDSeed(word* rand)
+{
+	octet ok = 0;
+	__asm {
+		xor eax, eax
+		rdseed_eax
+		jnc rngRDSeed_fail
+		mov edx, rand
+		mov [edx], eax
+		mov ok, 1
+	rngRDSeed_fail:
 	}
-rngSeedTRNG_break:
-	*read = i;
-	return ERR_OK;
+	return ok;
 }
 
+#define RNG_HAS_CPUID
+
 #elif defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
 
 #include <cpuid.h>
 
-static bool_t rngHasTRNG()
+static void rngCPUID(u32 info[4], u32 leaf)
+{
+	__cpuid_count(leaf, 0, info[0], info[1], info[2], info[3]);
+}
+
+static bool_t rngRDRand(word* rand)
+{
+	octet ok;
+	asm volatile ("rdrand %0; setc %1" : "=r" (*rand), "=qm" (ok));
+	return ok;
+}
+
+static bool_t rngRDSeed(word* rand)
+{
+	octet ok;
+	asm volatile ("rdseed %0; setc %1" : "=r" (*rand), "=qm" (ok));
+	return ok;
+}
+
+#define RNG_HAS_CPUID
+
+#endif
+
+#ifdef RNG_HAS_CPUID
+
+static int _trng_caps = -1;		/*< 0 / 1 (rdrand) / 3 (rdrand + rdseed) */
+
+static int rngTRNGCaps()
 {
 	u32 info[4];
+	u32 max_leaf;
+	int caps = 0;
+	if (_trng_caps >= 0)
+		return _trng_caps;
 	// Intel?
-	__cpuid(0, info[0], info[1], info[2], info[3]);
-	if (!memEq(info + 1, "Genu", 4) ||
-		!memEq(info + 3, "ineI", 4) ||
-		!memEq(info + 2, "ntel", 4))
-		return FALSE;
-	/* rdrand? */
-	__cpuid(1, info[0], info[1], info[2], info[3]);
-	 return (info[2] & 0x40000000) == 0x40000000;
+	rngCPUID(info, 0);
+	max_leaf = info[0];
+	if (memEq(info + 1, "Genu", 4) &&
+		memEq(info + 3, "ineI", 4) &&
+		memEq(info + 2, "ntel", 4))
+	{
+		// rdrand?
+		rngCPUID(info, 1);
+		if ((info[2] & 0x40000000) == 0x40000000)
+		{
+			caps = 1;
+			// rdseed?
+			if (max_leaf >= 7)
+			{
+				rngCPUID(info, 7);
+				if ((info[1] & 0x00040000) == 0x00040000)
+					caps = 3;
+			}
+		}
+	}
+	return _trng_caps = caps;
+}
+
+static bool_t rngReadWord(word* rand, int caps)
+{
+	size_t r;
+	if (caps & 2)
+		for (r = 0; r < RNG_RDSEED_RETRIES; ++r)
+			if (rngRDSeed(rand))
+				return TRUE;
+	for (r = 0; r < RNG_RDRAND_RETRIES; ++r)
+		if (rngRDRand(rand))
+			return TRUE;
+	return FALSE;
 }
 
 static err_t rngReadTRNG(size_t* read, void* buf, size_t count)
 {
 	word* rand = (word*)buf;
 	size_t i;
-	octet ok;
+	int caps;
 	// pre
 	ASSERT(memIsValid(read, sizeof(size_t)));
 	ASSERT(memIsValid(buf, count));
 	// есть источник?
-	if (!rngHasTRNG())
+	if (!(caps = rngTRNGCaps()))
 		return ERR_FILE_NOT_FOUND;
 	// короткий буфер?
 	if (count < O_PER_W)
@@ -140,11 +191,10 @@ static err_t rngReadTRNG(size_t* read, void* buf, size_t count)
 	{
 		if (i + O_PER_W > count)
 		{
-			i -= count - O_PER_W;
+			i = count - O_PER_W;
 			rand = (word*)((octet*)buf + i);
 		}
-		asm volatile ("rdrand %0; setc %1" : "=r" (*rand), "=qm" (ok));
-		if (!ok)
+		if (!rngReadWord(rand, caps))
 			break;
 	}
 	*read = i;
@@ -242,7 +292,10 @@ static err_t rngReadTimer(size_t* read, void* buf, size_t count)
 Системный источник
 
 Системный источник Windows -- это функция CryptGenRandom() поверх
-стандартного криптопровайдера PROV_RSA_FULL. Системный источник Unix -- 
+стандартного криптопровайдера PROV_RSA_FULL. Системный источник Linux --
+это системный вызов getrandom(2) (без открытия файлов). Если вызов 
+не поддерживается ядром или запрещен (например, профилем seccomp), 
+то используется файл dev/urandom. Системный источник других Unix -- 
 это файл dev/urandom. 
 
 Обсуждение (и критика) источников:
@@ -297,7 +350,7 @@ static err_t rngReadSys(size_t* read, void* buf, size_t count)
 
 #include <stdio.h>
 
-static err_t rngReadSys(size_t* read, void* buf, size_t count)
+static err_t rngReadSysFile(size_t* read, void* buf, size_t count)
 {
 	FILE* fp;
 	ASSERT(memIsValid(read, sizeof(size_t)));
@@ -310,6 +363,47 @@ static err_t rngReadSys(size_t* read, void* buf, size_t count)
 	return ERR_OK;
 }
 
+#if defined OS_LINUX
+
+#include <errno.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#endif
+
+#if defined OS_LINUX && defined SYS_getrandom
+
+static err_t rngReadSys(size_t* read, void* buf, size_t count)
+{
+	size_t done = 0;
+	long r;
+	ASSERT(memIsValid(read, sizeof(size_t)));
+	ASSERT(memIsValid(buf, count));
+	while (done < count)
+	{
+		r = syscall(SYS_getrandom, (octet*)buf + done, count - done, 0);
+		if (r > 0)
+			done += (size_t)r;
+		else if (r < 0 && errno == EINTR)
+			continue;
+		else if (done == 0)
+			return rngReadSysFile(read, buf, count);
+		else
+			break;
+	}
+	*read = done;
+	return ERR_OK;
+}
+
+#else
+
+static err_t rngReadSys(size_t* read, void* buf, size_t count)
+{
+	return rngReadSysFile(read, buf, count);
+}
+
+#endif
+
 #else
 
 static err_t rngReadSys(size_t* read, void* buf, size_t count)
@@ -434,7 +528,92 @@ err_t rngReadSource(size_t* read, void* buf, size_t count,
 
 /*
 *******************************************************************************
-Создание / закрытие генератора
+Контроль работоспособности источников
+
+Работоспособность источника проверяется с помощью тестов FIPS 140-2: 
+от источника получается 2500 октетов, к ним применяются тесты 
+rngTestFIPS1()--rngTestFIPS4(). При отказе проверка повторяется
+(на новых данных) один раз. Тем самым вероятность ложного отказа 
+для истинно случайных данных не превосходит (4 * 0.01)^2.
+
+Внутри генератора проверки выполняются выборочно: каждый RNG_HEALTH_PERIOD-й 
+опрос источников (при создании генератора и при пересевах) предваряется 
+проверкой очередного источника (по кругу). Источник, не прошедший проверку, 
+не опрашивается до следующей успешной проверки.
+
+Функция rngHealthNext() выбирает источник для очередной проверки
+(COUNT_OF(_sources) -- проверка не требуется). Счетчик _health_count и 
+флаги _sources_bad изменяются только под мьютексом _mtx. Сама проверка 
+(чтение 2500 октетов) выполняется без блокировки, см. rngHealthTick(). 
+Флаги читаются в rngReadHealthy() без блокировки: устаревшее значение 
+флага лишь откладывает отключение (включение) источника до следующего 
+опроса.
+*******************************************************************************
+*/
+
+#define RNG_HEALTH_PERIOD 64
+
+static const char* _sources[] = {"trng", "timer", "sys"};
+static volatile bool_t _sources_bad[COUNT_OF(_sources)];
+static size_t _health_count;
+
+err_t rngTestSource(const char* source_name)
+{
+	octet buf[2500];
+	size_t read;
+	size_t attempt;
+	err_t code = ERR_OK;
+	ASSERT(strIsValid(source_name));
+	for (attempt = 0; attempt < 2; ++attempt)
+	{
+		code = rngReadSource(&read, buf, 2500, source_name);
+		if (code != ERR_OK)
+			break;
+		if (read < 2500)
+		{
+			code = ERR_INSUFFICIENT_ENTROPY;
+			break;
+		}
+		if (rngTestFIPS1(buf) && rngTestFIPS2(buf) && 
+			rngTestFIPS3(buf) && rngTestFIPS4(buf))
+			break;
+		code = ERR_BAD_RNG;
+	}
+	memWipe(buf, sizeof(buf));
+	return code;
+}
+
+static size_t rngHealthNext()
+{
+	size_t n = _health_count++;
+	if (n % RNG_HEALTH_PERIOD)
+		return COUNT_OF(_sources);
+	return n / RNG_HEALTH_PERIOD % COUNT_OF(_sources);
+}
+
+static err_t rngReadHealthy(size_t* read, void* buf, size_t count, size_t i)
+{
+	ASSERT(i < COUNT_OF(_sources));
+	if (_sources_bad[i])
+		return ERR_BAD_RNG;
+	return rngReadSource(read, buf, count, _sources[i]);
+}
+
+/*
+*******************************************************************************
+Глобальный генератор
+
+Глобальный генератор (объект _state) используется только для засева
+и пересева потоковых экземпляров, а также как запасной вариант, когда 
+потоковые экземпляры недоступны. Обращения к глобальному генератору 
+защищены мьютексом _mtx.
+
+Счетчик _epoch увеличивается при каждом (фактическом) создании глобального 
+генератора. Счетчик _fork увеличивается в дочернем процессе после fork(). 
+Потоковый экземпляр, засеянный в другой эпохе или до fork(), пересевается.
+Глобальный генератор после fork() перед первым использованием пересевается
+с помощью источников случайности. Тем самым родительский и дочерний процессы 
+не выдают одинаковых последовательностей.
 *******************************************************************************
 */
 
@@ -450,16 +629,263 @@ typedef struct
 static size_t _lock;			/*< счетчик блокировок */
 static mt_mtx_t _mtx[1];		/*< мьютекс */
 static rng_state_o* _state;		/*< состояние */
+static size_t _epoch;			/*< эпоха глобального генератора */
+static volatile size_t _fork;	/*< число fork() */
+static size_t _state_fork;		/*< значение _fork при засеве _state */
+static size_t _state_octets;	/*< выработано октетов после засева _state */
+static size_t _state_calls;		/*< обращений к _state после засева */
+static tm_time_t _state_time;	/*< время засева _state */
 
 size_t rngCreate_keep()
 {
 	return sizeof(rng_state_o) + MAX2(beltHash_keep(), brngCTR_keep());
 }
 
+/*
+*******************************************************************************
+Политика пересева
+
+Генератор (глобальный или потоковый) пересевается, если после последнего 
+засева выработано не менее _reseed_octets октетов, выполнено не менее 
+_reseed_calls обращений или прошло не менее _reseed_secs секунд. Нулевое 
+значение отключает соответствующий критерий.
+
+Параметры политики читаются без блокировки: изменение параметров 
+вступает в силу не обязательно сразу во всех потоках.
+*******************************************************************************
+*/
+
+static size_t _reseed_octets = RNG_RESEED_OCTETS;
+static size_t _reseed_calls = RNG_RESEED_CALLS;
+static size_t _reseed_secs = RNG_RESEED_SECS;
+
+void rngSetReseed(size_t octets, size_t calls, size_t secs)
+{
+	_reseed_octets = octets;
+	_reseed_calls = calls;
+	_reseed_secs = secs;
+}
+
+static bool_t rngIsStale(size_t octets, size_t calls, tm_time_t time)
+{
+	tm_time_t t;
+	if (_reseed_octets && octets >= _reseed_octets ||
+		_reseed_calls && calls >= _reseed_calls)
+		return TRUE;
+	if (!_reseed_secs)
+		return FALSE;
+	t = tmTime();
+	return t < time || (size_t)(t - time) >= _reseed_secs;
+}
+
+/*
+*******************************************************************************
+Пересев глобального генератора
+
+Данные от источников случайности последовательно обрабатываются в brngCTR 
+как входы X_t. Последний выход Y_t становится новым ключом brngCTR.
+
+\pre Мьютекс _mtx заблокирован.
+*******************************************************************************
+*/
+
+static void rngRekey()
+{
+	size_t read;
+	size_t i;
+	ASSERT(blobIsValid(_state));
+	for (i = 0; i < COUNT_OF(_sources); ++i)
+	{
+		memSetZero(_state->data, 32);
+		rngReadHealthy(&read, _state->data, 32, i);
+		brngCTRStepR(_state->data, 32, _state->alg_state);
+	}
+	brngCTRStart(_state->alg_state, _state->data, 0);
+	memSetZero(_state->data, 32);
+	_state_fork = _fork, _state_octets = _state_calls = 0;
+	_state_time = tmTime();
+}
+
+/*
+*******************************************************************************
+Обращение к глобальному генератору
+
+В буфер [count]buf записываются выходные данные глобального генератора.
+Входом brngCTR служит исходное содержимое buf. Перед обращением генератор 
+пересевается, если это требуется по политике пересева или после fork().
+
+\pre Мьютекс _mtx заблокирован.
+*******************************************************************************
+*/
+
+static bool_t rngStateIsDue()
+{
+	ASSERT(blobIsValid(_state));
+	return _state_fork != _fork || 
+		rngIsStale(_state_octets, _state_calls, _state_time);
+}
+
+static void rngStateStepR(void* buf, size_t count)
+{
+	ASSERT(blobIsValid(_state));
+	if (rngStateIsDue())
+		rngRekey();
+	brngCTRStepR(buf, count, _state->alg_state);
+	_state_octets += count, ++_state_calls;
+}
+
+/*
+*******************************************************************************
+Выборочный контроль источников
+
+Функция rngHealthTick() вызывается перед опросом источников (засевом
+потокового экземпляра, пересевом глобального генератора). Выбор источника
+и публикация результата проверки выполняются под мьютексом _mtx, сама 
+проверка -- без блокировки. Тем самым другие потоки не ждут окончания 
+проверки.
+
+\pre Мьютекс _mtx не заблокирован вызывающим потоком.
+*******************************************************************************
+*/
+
+static void rngHealthTick()
+{
+	size_t i;
+	bool_t bad;
+	mtMtxLock(_mtx);
+	i = rngHealthNext();
+	mtMtxUnlock(_mtx);
+	if (i == COUNT_OF(_sources))
+		return;
+	bad = rngTestSource(_sources[i]) == ERR_BAD_RNG;
+	mtMtxLock(_mtx);
+	_sources_bad[i] = bad;
+	mtMtxUnlock(_mtx);
+}
+
+/*
+*******************************************************************************
+Локальная память потоков
+
+Потоковые экземпляры генератора хранятся в локальной памяти потоков 
+(TLS в Unix, FLS в Windows). При завершении потока экземпляр 
+освобождается с помощью blobClose().
+
+Ключ локальной памяти создается один раз (при первом создании генератора)
+и не удаляется. Если локальная память недоступна, то rngStepG() 
+обращается к глобальному генератору под мьютексом.
+
+В Unix при первом создании генератора регистрируются обработчики fork(). 
+Обработчики блокируют _mtx на время fork() (чтобы дочерний процесс 
+не унаследовал заблокированный мьютекс) и увеличивают счетчик _fork 
+в дочернем процессе.
+*******************************************************************************
+*/
+
+static bool_t _tls;				/*< локальная память подготовлена */
+
+#if defined OS_UNIX
+
+static pthread_key_t _tls_key;	/*< ключ локальной памяти */
+static bool_t _fork_locked;		/*< мьютекс заблокирован на время fork() */
+
+static void rngForkPrepare()
+{
+	if (_lock)
+	{
+		mtMtxLock(_mtx);
+		_fork_locked = TRUE;
+	}
+}
+
+static void rngForkParent()
+{
+	if (_fork_locked)
+	{
+		_fork_locked = FALSE;
+		mtMtxUnlock(_mtx);
+	}
+}
+
+static void rngForkChild()
+{
+	++_fork;
+	rngForkParent();
+}
+
+static bool_t rngTLSCreate()
+{
+	if (pthread_key_create(&_tls_key, blobClose) != 0)
+		return FALSE;
+	pthread_atfork(rngForkPrepare, rngForkParent, rngForkChild);
+	return TRUE;
+}
+
+static void* rngTLSGet()
+{
+	return pthread_getspecific(_tls_key);
+}
+
+static bool_t rngTLSSet(void* ptr)
+{
+	return pthread_setspecific(_tls_key, ptr) == 0;
+}
+
+#elif defined OS_WIN
+
+static DWORD _tls_key;			/*< ключ локальной памяти */
+
+static void WINAPI rngTLSClose(void* ptr)
+{
+	blobClose(ptr);
+}
+
+static bool_t rngTLSCreate()
+{
+	_tls_key = FlsAlloc(rngTLSClose);
+	return _tls_key != FLS_OUT_OF_INDEXES;
+}
+
+static void* rngTLSGet()
+{
+	return FlsGetValue(_tls_key);
+}
+
+static bool_t rngTLSSet(void* ptr)
+{
+	return FlsSetValue(_tls_key, ptr) != 0;
+}
+
+#else
+
+static bool_t rngTLSCreate()
+{
+	return FALSE;
+}
+
+static void* rngTLSGet()
+{
+	return 0;
+}
+
+static bool_t rngTLSSet(void* ptr)
+{
+	return FALSE;
+}
+
+#endif
+
+/*
+*******************************************************************************
+Создание / закрытие генератора
+*******************************************************************************
+*/
+
 err_t rngCreate(read_i source, void* source_state)
 {
 	size_t read;
 	size_t count;
+	size_t i;
 	// уже создан?
 	if (_lock)
 	{
@@ -483,19 +909,23 @@ err_t rngCreate(read_i source, void* source_state)
 	_state->hdr.o_count = 0;
 	_state->alg_state = _state->data + 32;
 	// опрос источников случайности
+	// (генератор еще не доступен другим потокам, проверка под _mtx 
+	// никого не задерживает)
+	if ((i = rngHealthNext()) < COUNT_OF(_sources))
+		_sources_bad[i] = rngTestSource(_sources[i]) == ERR_BAD_RNG;
 	count = 0;
 	beltHashStart(_state->alg_state);
-	if (rngReadSource(&read, _state->data, 32, "trng") == ERR_OK)
+	if (rngReadHealthy(&read, _state->data, 32, 0) == ERR_OK)
 	{
 		beltHashStepH(_state->data, read, _state->alg_state);
 		count += read;
 	}
-	if (rngReadSource(&read, _state->data, 32, "timer") == ERR_OK)
+	if (rngReadHealthy(&read, _state->data, 32, 1) == ERR_OK)
 	{
 		beltHashStepH(_state->data, read, _state->alg_state);
 		count += read;
 	}
-	if (rngReadSource(&read, _state->data, 32, "sys") == ERR_OK)
+	if (rngReadHealthy(&read, _state->data, 32, 2) == ERR_OK)
 	{
 		beltHashStepH(_state->data, read, _state->alg_state);
 		count += read;
@@ -515,6 +945,13 @@ err_t rngCreate(read_i source, void* source_state)
 	beltHashStepG(_state->data, _state->alg_state);
 	brngCTRStart(_state->alg_state, _state->data, 0);
 	memSetZero(_state->data, 32);
+	// подготовить локальную память
+	if (!_tls)
+		_tls = rngTLSCreate();
+	// новая эпоха
+	++_epoch;
+	_state_fork = _fork, _state_octets = _state_calls = 0;
+	_state_time = tmTime();
 	// завершение
 	_lock = 1;
 	mtMtxUnlock(_mtx);
@@ -532,9 +969,16 @@ void rngClose()
 	mtMtxLock(_mtx);
 	if (--_lock == 0)
 	{
+		void* thread_state;
 		blobClose(_state);
 		mtMtxUnlock(_mtx);
 		mtMtxClose(_mtx);
+		// освободить экземпляр вызывающего потока
+		if (_tls && (thread_state = rngTLSGet()) != 0)
+		{
+			rngTLSSet(0);
+			blobClose(thread_state);
+		}
 	}
 	else
 		mtMtxUnlock(_mtx);
@@ -542,31 +986,372 @@ void rngClose()
 
 /*
 *******************************************************************************
-Генерация
+Потоковые экземпляры
+
+Экземпляр -- это состояние brngCTR, ключ которого получен от глобального 
+генератора. При засеве данные от источников случайности (опрашиваются 
+без блокировки) обрабатываются глобальным генератором, выход становится 
+ключом экземпляра. Экземпляр пересевается по политике пересева, при смене 
+эпохи и после fork().
 *******************************************************************************
 */
 
-void rngStepG(void* buf, size_t count, void* state)
+typedef struct
+{
+	size_t epoch;				/*< эпоха глобального генератора при засеве */
+	size_t fork;				/*< значение _fork при засеве */
+	size_t octets;				/*< число октетов, выработанных после засева */
+	size_t calls;				/*< число обращений после засева */
+	tm_time_t time;				/*< время засева */
+	octet* alg_state;			/*< [brngCTR_keep()] */
+} rng_thread_st;
+
+static size_t rngThread_keep()
+{
+	return sizeof(rng_thread_st) + brngCTR_keep();
+}
+
+static void rngPoll(void* buf, size_t count)
 {
 	size_t read;
-	ASSERT(rngIsValid());
-	// блокировать генератор
-	mtMtxLock(_mtx);
-	// опросить источники случайности
-	if (rngReadSource(&read, buf, count, "trng") != ERR_OK)
+	if (rngReadHealthy(&read, buf, count, 0) != ERR_OK)
 		read = 0;
 	if (read < count)
 	{
 		octet* buf1 = (octet*)buf + read;
 		size_t t;
-		if (rngReadSource(&t, buf1, count - read, "timer") != ERR_OK)
+		if (rngReadHealthy(&t, buf1, count - read, 1) != ERR_OK)
 			t = 0;
 		if ((read += t) < count)
-			rngReadSource(&t, buf1 + t, count - read, "sys");
+			rngReadHealthy(&t, buf1 + t, count - read, 2);
 	}
-	// генерация
-	brngCTRStepR(buf, count, _state->alg_state);
-	// снять блокировку
+}
+
+static void rngThreadSeed(rng_thread_st* t)
+{
+	octet key[32];
+	// опросить источники случайности
+	memSetZero(key, 32);
+	rngHealthTick();
+	rngPoll(key, 32);
+	// обработать данные глобальным генератором
+	mtMtxLock(_mtx);
+	rngStateStepR(key, 32);
+	mtMtxUnlock(_mtx);
+	// засеять экземпляр
+	brngCTRStart(t->alg_state, key, 0);
+	memSetZero(key, 32);
+	t->epoch = _epoch, t->fork = _fork, t->octets = t->calls = 0;
+	t->time = tmTime();
+}
+
+static rng_thread_st* rngThreadGet()
+{
+	rng_thread_st* t;
+	// локальная память недоступна?
+	if (!_tls)
+		return 0;
+	// создать экземпляр
+	if (!(t = (rng_thread_st*)rngTLSGet()))
+	{
+		t = (rng_thread_st*)blobCreate(rngThread_keep());
+		if (!t)
+			return 0;
+		if (!rngTLSSet(t))
+		{
+			blobClose(t);
+			return 0;
+		}
+		t->alg_state = (octet*)t + sizeof(rng_thread_st);
+	}
+	// засеять / пересеять
+	if (t->epoch != _epoch || t->fork != _fork ||
+		rngIsStale(t->octets, t->calls, t->time))
+		rngThreadSeed(t);
+	return t;
+}
+
+/*
+*******************************************************************************
+Генерация
+
+Источники случайности опрашиваются только при засеве и пересеве. 
+Выходные данные -- это выход brngCTR на нулевых входах X_t.
+*******************************************************************************
+*/
+
+void rngStepG(void* buf, size_t count, void* state)
+{
+	rng_thread_st* t;
+	ASSERT(rngIsValid());
+	memSetZero(buf, count);
+	// потоковый экземпляр
+	if ((t = rngThreadGet()) != 0)
+	{
+		brngCTRStepR(buf, count, t->alg_state);
+		t->octets += count, ++t->calls;
+		return;
+	}
+	// глобальный генератор
+	mtMtxLock(_mtx);
+	if (rngStateIsDue())
+	{
+		// проверка источников перед пересевом -- без блокировки
+		mtMtxUnlock(_mtx);
+		rngHealthTick();
+		mtMtxLock(_mtx);
+	}
+	rngStateStepR(buf, count);
 	mtMtxUnlock(_mtx);
 }
 
+/*
+*******************************************************************************
+Буферизованный генератор
+
+Кольцевой буфер ring вмещает size октетов. Заполненная часть буфера 
+начинается с позиции head и имеет длину filled (с переходом через конец 
+буфера). Фоновый поток дописывает в буфер порции выходных данных rngStepG() 
+длины не более RNG_POOL_CHUNK. Порции вырабатываются без блокировки буфера, 
+блокировка требуется только для копирования.
+
+Если свободной памяти меньше порции (или половины буфера, если она меньше 
+порции), то поток приостанавливается. Длительность паузы удваивается
+(от 1 до RNG_POOL_SLEEP_MAX мс), пока буфер остается заполненным, и 
+сбрасывается после пополнения. Поэтому поток простаивающего генератора 
+просыпается не чаще 1000 / RNG_POOL_SLEEP_MAX раз в секунду. Если за 
+время паузы буфер опустел, то запросы обслуживаются rngStepG().
+
+Прочитанные октеты буфера сразу же затираются.
+
+В Unix при создании буфера регистрируются обработчики fork(). Обработчики 
+блокируют мьютекс буфера на время fork(). В дочернем процессе буфер 
+затирается: иначе родительский и дочерний процессы выдали бы одинаковые 
+данные. Фонового потока в дочернем процессе нет (fork() копирует только
+вызывающий поток), и признак active сбрасывается. Остановленный поток 
+перезапускается при первом обращении к буферу, а при закрытии буфера 
+не ожидается. Дополнительно в поле fork запоминается значение _fork, 
+при котором был запущен поток: несовпадение fork и _fork также означает,
+что буфер унаследован от родительского процесса.
+*******************************************************************************
+*/
+
+#define RNG_POOL_CHUNK 256
+#define RNG_POOL_SLEEP_MAX 64
+
+typedef struct
+{
+	mt_mtx_t mtx[1];			/*< мьютекс */
+	mt_thrd_t thrd[1];			/*< фоновый поток */
+	size_t fork;				/*< значение _fork при запуске потока */
+	bool_t active;				/*< поток запущен */
+	bool_t stop;				/*< признак остановки потока */
+	size_t size;				/*< размер буфера */
+	size_t head;				/*< начало заполненной части */
+	size_t filled;				/*< длина заполненной части */
+	octet* ring;				/*< [size] кольцевой буфер */
+} rng_pool_st;
+
+static size_t _pool_lock;		/*< счетчик блокировок буфера */
+static rng_pool_st* _pool;		/*< буфер */
+
+static void rngPoolThread(void* arg)
+{
+	rng_pool_st* p = (rng_pool_st*)arg;
+	octet chunk[RNG_POOL_CHUNK];
+	size_t count, pos, t;
+	size_t ms = 1;
+	while (1)
+	{
+		// свободная память
+		mtMtxLock(p->mtx);
+		if (p->stop)
+		{
+			mtMtxUnlock(p->mtx);
+			break;
+		}
+		count = MIN2(p->size - p->filled, RNG_POOL_CHUNK);
+		mtMtxUnlock(p->mtx);
+		if (count == 0 || count < MIN2(p->size / 2, RNG_POOL_CHUNK))
+		{
+			mtSleep(ms);
+			ms = MIN2(2 * ms, RNG_POOL_SLEEP_MAX);
+			continue;
+		}
+		ms = 1;
+		// выработать порцию
+		rngStepG(chunk, count, 0);
+		// дописать порцию (свободная память могла только увеличиться)
+		mtMtxLock(p->mtx);
+		pos = (p->head + p->filled) % p->size;
+		t = MIN2(count, p->size - pos);
+		memCopy(p->ring + pos, chunk, t);
+		memCopy(p->ring, chunk + t, count - t);
+		p->filled += count;
+		mtMtxUnlock(p->mtx);
+		memWipe(chunk, count);
+	}
+}
+
+/*
+	Запуск фонового потока.
+	\pre Мьютекс буфера заблокирован (или поток еще не запускался).
+*/
+
+static bool_t rngPoolStart(rng_pool_st* p)
+{
+	p->fork = _fork;
+	p->stop = FALSE;
+	p->active = mtThrdCreate(p->thrd, rngPoolThread, p);
+	return p->active;
+}
+
+#if defined OS_UNIX
+
+static bool_t _pool_atfork;		/*< обработчики fork() зарегистрированы */
+static bool_t _pool_locked;		/*< мьютекс буфера заблокирован */
+
+static void rngPoolForkPrepare()
+{
+	if (_pool_lock)
+	{
+		mtMtxLock(_pool->mtx);
+		_pool_locked = TRUE;
+	}
+}
+
+static void rngPoolForkParent()
+{
+	if (_pool_locked)
+	{
+		_pool_locked = FALSE;
+		mtMtxUnlock(_pool->mtx);
+	}
+}
+
+static void rngPoolForkChild()
+{
+	if (_pool_locked)
+	{
+		memWipe(_pool->ring, _pool->size);
+		_pool->head = _pool->filled = 0;
+		_pool->active = FALSE;
+	}
+	rngPoolForkParent();
+}
+
+static void rngPoolAtFork()
+{
+	if (!_pool_atfork)
+		_pool_atfork = pthread_atfork(rngPoolForkPrepare, 
+			rngPoolForkParent, rngPoolForkChild) == 0;
+}
+
+#else
+
+static void rngPoolAtFork()
+{
+}
+
+#endif
+
+err_t rngPoolCreate(size_t size)
+{
+	err_t code;
+	// уже создан?
+	if (_pool_lock)
+	{
+		++_pool_lock;
+		return ERR_OK;
+	}
+	// pre
+	if (size == 0)
+		return ERR_BAD_INPUT;
+	// подключиться к генератору
+	code = rngCreate(0, 0);
+	ERR_CALL_CHECK(code);
+	// создать буфер
+	_pool = (rng_pool_st*)blobCreate(sizeof(rng_pool_st) + size);
+	if (!_pool)
+	{
+		rngClose();
+		return ERR_NOT_ENOUGH_MEMORY;
+	}
+	_pool->size = size;
+	_pool->ring = (octet*)_pool + sizeof(rng_pool_st);
+	// создать мьютекс и фоновый поток
+	if (!mtMtxCreate(_pool->mtx))
+	{
+		blobClose(_pool);
+		rngClose();
+		return ERR_CANNOT_MAKE;
+	}
+	if (!rngPoolStart(_pool))
+	{
+		mtMtxClose(_pool->mtx);
+		blobClose(_pool);
+		rngClose();
+		return ERR_CANNOT_MAKE;
+	}
+	// завершение
+	_pool_lock = 1;
+	rngPoolAtFork();
+	return ERR_OK;
+}
+
+bool_t rngPoolIsValid()
+{
+	return _pool_lock > 0 && blobIsValid(_pool) && 
+		mtMtxIsValid(_pool->mtx) && rngIsValid();
+}
+
+void rngPoolStepG(void* buf, size_t count, void* state)
+{
+	rng_pool_st* p = _pool;
+	size_t read, t;
+	ASSERT(rngPoolIsValid());
+	ASSERT(memIsValid(buf, count));
+	mtMtxLock(p->mtx);
+	// после fork(): затереть буфер
+	if (p->fork != _fork)
+	{
+		memWipe(p->ring, p->size);
+		p->head = p->filled = 0;
+		p->active = FALSE;
+	}
+	// поток не запущен: запустить
+	if (!p->active)
+		rngPoolStart(p);
+	// прочитать данные из буфера и затереть их
+	read = MIN2(count, p->filled);
+	t = MIN2(read, p->size - p->head);
+	memCopy(buf, p->ring + p->head, t);
+	memWipe(p->ring + p->head, t);
+	memCopy((octet*)buf + t, p->ring, read - t);
+	memWipe(p->ring, read - t);
+	p->head = (p->head + read) % p->size;
+	p->filled -= read;
+	mtMtxUnlock(p->mtx);
+	// данных не хватило?
+	if (read < count)
+		rngStepG((octet*)buf + read, count - read, 0);
+}
+
+void rngPoolClose()
+{
+	bool_t active;
+	ASSERT(rngPoolIsValid());
+	if (--_pool_lock)
+		return;
+	// остановить фоновый поток (если он запущен в этом процессе)
+	mtMtxLock(_pool->mtx);
+	_pool->stop = TRUE;
+	active = _pool->active && _pool->fork == _fork;
+	mtMtxUnlock(_pool->mtx);
+	if (active)
+		mtThrdJoin(_pool->thrd);
+	// освободить ресурсы
+	mtMtxClose(_pool->mtx);
+	blobClose(_pool), _pool = 0;
+	rngClose();
+}
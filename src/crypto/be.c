@@ -10,12 +10,11 @@
 
 #include "bee2/crypto/be.h"
 #include "bee2/crypto/belt.h"
+#include "bee2/core/blob.h"
 #include "bee2/core/mem.h"
+#include "bee2/core/mt.h"
 #include "bee2/math/sd.h"
 
-#define BE_SIZE_IMITO 8
-#define BE_SIZE_SYNHRO 16
-
 /*    Массив для быстрого поиска ключей в массиве всех ключей
     Строится по правилу: 
     for (h=3; h<26; h++) // h=25 - максимальное значение
@@ -139,6 +138,99 @@ static err_t beDataWrap( u8 *pKey, u32 lenKey, u8 *pSynhro, u8 *pSrc, u8 *pDst,
 */
 static err_t beDataUnwrap( u8 *pKey, u32 lenKey, u8 *pSynhro, u8 *pSrc, u8 *pDst, u32 lenData );
 
+/*
+Задание на формирование ключей всех пользователей. Ключи C_{i,j} для различных 
+внутренних вершин i формируются независимо и записываются в непересекающиеся 
+участки массива pAKeys. Вершины i раздаются потокам в порядке возрастания, 
+т.е. от больших поддеревьев к меньшим.
+*/
+typedef struct
+{
+    u8 h;                /* высота дерева */
+    u8 sizeKey;            /* длина ключей в октетах */
+    u8 *S;                /* ключ центра */
+    beUserKey *pAKeys;    /* массив всех ключей */
+    u32 n;                /* число пользователей */
+    u32 next;            /* очередная вершина */
+    mt_mtx_t mtx;        /* мьютекс */
+} be_gen_st;
+
+/*
+Рабочее место потока: состояния belt-krp для ключа S (уровень 0)
+и для текущего ключа C_{i,j}, временный ключ C_{i,i}.
+*/
+typedef struct
+{
+    be_gen_st *gen;        /* задание */
+    void *stateS;        /* состояние belt-krp для S */
+    void *state;        /* состояние belt-krp для C_{i,j} */
+    u8 T[32];            /* ключ C_{i,i} */
+} be_gen_worker_st;
+
+/*
+Формирование ключей C_{i,b} для всех потомков b вершины i (шаг 4).
+Каждый ключ C_{i,j} загружается в состояние belt-krp один раз
+и порождает ключи обоих потомков вершины j.
+*/
+static void beGenNodeKeys(be_gen_worker_st *w, u32 i)
+{
+    be_gen_st *g = w->gen;
+    u32    j, d, t, count;
+    u32    Lvl[3];    /* уровень ключа */
+    u32    Hdr[4];    /* заголовок ключа */
+    u8 *   pInitKey;
+    beUserKey *pOutKey1, *pOutKey2;
+    
+    memSet(Lvl, 0, sizeof(Lvl));
+    memSet(Hdr, 0, sizeof(Hdr));
+    Hdr[0] = i;
+    beltKRPStepG(w->T, g->sizeKey, (u8 *)Hdr, w->stateS);
+    d = beGetDepth(i);
+    for (t=0; t<g->h-d; t++)
+    {
+        Lvl[0] = t+1;
+        for (j=(1<<t)*i; j<(1<<t)*i+(1<<t); j++)
+        {
+            count = beOffsetAKey[g->h-3][d]+j-(1<<(d+1));
+            if (i==j)
+                pInitKey = w->T;
+            else
+                pInitKey = (g->pAKeys + count)->key;
+            pOutKey1 = g->pAKeys + count + j;
+            pOutKey2 = g->pAKeys + count + j + 1;
+            beltKRPStart(w->state, pInitKey, g->sizeKey, (u8 *)Lvl);
+            Hdr[0] = 1;
+            pOutKey1->a = i; 
+            pOutKey1->b = 2*j;
+            beltKRPStepG(pOutKey1->key, g->sizeKey, (u8 *)Hdr, w->state);
+            Hdr[0] = 2;
+            pOutKey2->a = i; 
+            pOutKey2->b = 2*j+1;
+            beltKRPStepG(pOutKey2->key, g->sizeKey, (u8 *)Hdr, w->state);
+        }
+    }
+}
+
+/*
+Функция потока: выбирает очередную вершину i и формирует ее ключи.
+*/
+static void beGenWorker(void *arg)
+{
+    be_gen_worker_st *w = (be_gen_worker_st *)arg;
+    be_gen_st *g = w->gen;
+    u32    i;
+    
+    while (1)
+    {
+        mtMtxLock(&g->mtx);
+        i = g->next++;
+        mtMtxUnlock(&g->mtx);
+        if (i >= g->n)
+            break;
+        beGenNodeKeys(w, i);
+    }
+}
+
 /*
 Функция на основании ключа центра передачи S генерирует ключи всех пользователей 
 (реализует шаги 1-4 алгоритма формирования  ключей пользователей) и сохраняет 
@@ -148,14 +240,29 @@ static err_t beDataUnwrap( u8 *pKey, u32 lenKey, u8 *pSynhro, u8 *pSrc, u8 *pDst
 */
 err_t beGenUsersKeys(u8 h, u16 m, u8 *S, beUserKey *pAKeys, u32 *pCount)
 {
-    u32    ret, i, j, d, t, n, count;
+    return beGenUsersKeysMT(h, m, S, pAKeys, pCount, 1);
+}
+
+/*
+Функция аналогична beGenUsersKeys, но ключи формируются в threads потоках. 
+Работа распределяется между потоками по внутренним вершинам дерева: 
+ключи C_{i,j} для различных вершин i формируются независимо. Каждый поток 
+использует собственные состояния belt-krp. Результат не зависит от threads. 
+Если потоки не удается создать, то ключи формируются в вызывающем потоке.
+*/
+err_t beGenUsersKeysMT(u8 h, u16 m, u8 *S, beUserKey *pAKeys, u32 *pCount, 
+    u32 threads)
+{
+    u32    ret, i;
     u32    Lvl[3];    /* уровень ключа */
     u32    Hdr[4];    /* заголовок ключа */
     u8    A[32];
     u8    sizeKey;
-    u8 *   pInitKey;
-    beUserKey *pUKey, *pOutKey1, *pOutKey2;
-    u8 * pTempKeys; /* массив временных ключей */
+    void *state;
+    be_gen_st *g;
+    be_gen_worker_st *w;
+    mt_thrd_t *thrds;
+    octet *krp;
     
     if ((h < 3) || (h > BE_MAX_HEIGHT)) 
         return ERR_INVALID_PARAMETER;
@@ -166,12 +273,10 @@ err_t beGenUsersKeys(u8 h, u16 m, u8 *S, beUserKey *pAKeys, u32 *pCount)
         return ERR_OK;
     if ((m != 128) && (m != 192) && (m != 256)) 
         return ERR_INVALID_PARAMETER;
-    if (S == NULL) 
+    if ((S == NULL) || (threads == 0)) 
         return ERR_INVALID_PARAMETER;
     
     sizeKey = (u8)(m/8);
-    n = 1<<h;
-    *pCount = beOffsetAKey[h-3][h]; /* количество всех ключей */
     
     /* шаг 2*/
     memSet(Lvl, 0, sizeof(Lvl));
@@ -181,74 +286,53 @@ err_t beGenUsersKeys(u8 h, u16 m, u8 *S, beUserKey *pAKeys, u32 *pCount)
         return ret;
     
     /* особый случай: все пользователи разрешены */
-    pUKey = pAKeys;
     /* вычислим и сохраним ключ пользователя для особого случая (шаг 3)*/
-    pUKey->a = 0; 
-    pUKey->b = 0;
+    pAKeys->a = 0; 
+    pAKeys->b = 0;
     Lvl[0] = 1;
-    ret = beKeyRep(A, sizeKey, Lvl, Hdr, pUKey->key);
+    ret = beKeyRep(A, sizeKey, Lvl, Hdr, pAKeys->key);
     memSet(A, 0, sizeof(A));
     if (ret != ERR_OK) 
         return ret;
     
-    /* выделим память под временные ключи */
-    pTempKeys =  memAlloc(sizeKey*n);
-    if (pTempKeys == NULL) 
+    /* подготовим потоки */
+    if (threads > (1u << h) - 1)
+        threads = (1u << h) - 1;
+    state = blobCreate(sizeof(be_gen_st) + 
+        threads * (sizeof(be_gen_worker_st) + sizeof(mt_thrd_t) + 
+            2 * beltKRP_keep()));
+    if (state == NULL) 
         return ERR_NOT_ENOUGH_MEMORY;
-    
-    memcpy(pTempKeys, pUKey->key, sizeKey);
-    
-    /* вычислим остальные ключи*/
-    for (i=1; i<n; i++) /* шаг 4*/
+    g = (be_gen_st *)state;
+    w = (be_gen_worker_st *)(g + 1);
+    thrds = (mt_thrd_t *)(w + threads);
+    krp = (octet *)(thrds + threads);
+    if (!mtMtxCreate(&g->mtx))
     {
-        Lvl[0] = 0; 
-        Hdr[0] = i;
-        ret = beKeyRep(S, sizeKey, Lvl, Hdr, pTempKeys+i*sizeKey);
-        if (ret != ERR_OK) 
-        {
-            memSet(pTempKeys, 0, sizeKey*n);
-            memFree(pTempKeys);
-            return ret;
-        }
-        d = beGetDepth(i);
-        for (t=0; t<h-d; t++)
-            for (j=(1<<t)*i; j<(1<<t)*i+(1<<t); j++)
-            {
-                count = beOffsetAKey[h-3][d]+j-(1<<(d+1));
-                if (i==j)
-                    pInitKey = pTempKeys+i*sizeKey;
-                else
-                {
-                    pUKey = pAKeys + count;
-                    pInitKey = pUKey->key;
-                }
-                pOutKey1 = pAKeys + count + j;
-                pOutKey2 = pAKeys + count + j + 1;
-                Lvl[0] = t+1;
-                Hdr[0] = 1;
-                pOutKey1->a = i; 
-                pOutKey1->b = 2*j;
-                ret = beKeyRep(pInitKey, sizeKey, Lvl, Hdr, pOutKey1->key);
-                if (ret != ERR_OK) 
-                {
-                    memSet(pTempKeys, 0, sizeKey*n);
-                    free(pTempKeys);
-                    return ret;
-                }
-                Hdr[0] = 2;
-                pOutKey2->a = i; 
-                pOutKey2->b = 2*j+1;
-                ret = beKeyRep(pInitKey, sizeKey, Lvl, Hdr, pOutKey2->key);
-                if (ret != ERR_OK) 
-                {
-                    memSet(pTempKeys, 0, sizeKey*n);
-                    free(pTempKeys);
-                    return ret;
-                }
-            }        
+        blobClose(state);
+        return ERR_INTERNAL;
+    }
+    g->h = h, g->sizeKey = sizeKey, g->S = S, g->pAKeys = pAKeys;
+    g->n = 1 << h, g->next = 1;
+    Lvl[0] = 0;
+    for (i=0; i<threads; i++)
+    {
+        w[i].gen = g;
+        w[i].stateS = krp + 2 * i * beltKRP_keep();
+        w[i].state = krp + (2 * i + 1) * beltKRP_keep();
+        beltKRPStart(w[i].stateS, S, sizeKey, (u8 *)Lvl);
     }
-    memSet(pTempKeys, 0, sizeKey*n);
-    free(pTempKeys);
+    
+    /* вычислим остальные ключи (шаг 4) */
+    for (i=1; i<threads; i++)
+        if (!mtThrdCreate(thrds + i, beGenWorker, w + i))
+            break;
+    beGenWorker(w);
+    while (--i)
+        mtThrdJoin(thrds + i);
+    
+    mtMtxClose(&g->mtx);
+    blobClose(state);
     return ERR_OK;
 }
 
@@ -326,6 +410,244 @@ err_t beGetUserKeys(u8 h, u16 m, u32 u, beUserKey *pAKeys, beUserKey *pUKeys, u3
     return ERR_OK;
 }
 
+/*
+Функция на основании ключа центра передачи S и номера пользователя u 
+вычисляет ключи пользователя u (реализует шаги 1-5 алгоритма формирования 
+ключей пользователей) и сохраняет их по указателю pUKeys. Ключи и их порядок 
+совпадают с теми, которые возвращает функция beGetUserKeys для массива, 
+сформированного функцией beGenUsersKeys. Массив всех ключей не формируется: 
+вычисляются только O(h^2) ключей, связанных с путем из корня в лист u. 
+При этом количество ключей пользователя записывается по указателю pCount. 
+В случае, если pUKeys = NULL функция не выполняет алгоритм, а возвращает 
+в pCount количество ключей для пользователя (при этом S может быть NULL). 
+*/
+err_t beDeriveUserKeys(u8 h, u16 m, u8 *S, u32 u, beUserKey *pUKeys, u32 *pCount)
+{
+    u32    ret, n;
+    u32    v[BE_MAX_HEIGHT+1];
+    u32    Lvl[3];    /* уровень ключа */
+    u32    Hdr[4];    /* заголовок ключа */
+    u8    A[32];    /* ключ C_{v_i,v_j} на пути из v_i в лист */
+    u8    sizeKey;
+    u32    i, j;
+    int        t;
+    
+    if ((h < 3) || (h > BE_MAX_HEIGHT)) 
+        return ERR_INVALID_PARAMETER;
+    n = 1 << h; /* 2^h */
+    if (pCount == NULL) 
+        return ERR_INVALID_PARAMETER;
+    *pCount = h*(h+1)/2+1; /* количество ключей пользователя */
+    if (pUKeys == NULL) 
+        return ERR_OK;
+    if ((m != 128) && (m != 192) && (m != 256)) 
+        return ERR_INVALID_PARAMETER;
+    if (S == NULL) 
+        return ERR_INVALID_PARAMETER;
+    if ((u == 0) || (u > n)) 
+        return ERR_INVALID_PARAMETER;
+    
+    sizeKey = (u8)(m/8);
+    memSet(Lvl, 0, sizeof(Lvl));
+    memSet(Hdr, 0, sizeof(Hdr));
+    
+    /* ключ C_{0,0} (шаги 2, 3) */
+    ret = beKeyRep(S, sizeKey, Lvl, Hdr, A);
+    if (ret != ERR_OK) 
+    {
+        memSet(A, 0, sizeof(A));
+        return ret;
+    }
+    Lvl[0] = 1;
+    pUKeys->a = 0;
+    pUKeys->b = 0;
+    ret = beKeyRep(A, sizeKey, Lvl, Hdr, pUKeys->key);
+    if (ret != ERR_OK) 
+    {
+        memSet(A, 0, sizeof(A));
+        return ret;
+    }
+    pUKeys++;
+    
+    /* вычислим путь из листа в корень*/
+    v[h] = u+n-1; /* номер листа, соответствующего номеру пользователя */
+    for (t=h-1; t>=0; t--)
+        v[t] = v[t+1]/2; 
+    
+    /* шаг 4 для вершин v[i] пути: спуск по пути с ответвлением 
+       в вершины, которые не лежат на пути */
+    for (i=0; i<h; i++)
+    {
+        Lvl[0] = 0; 
+        Hdr[0] = v[i];
+        ret = beKeyRep(S, sizeKey, Lvl, Hdr, A);
+        if (ret != ERR_OK) 
+        {
+            memSet(A, 0, sizeof(A));
+            return ret;
+        }
+        for (j=i; j<h; j++)
+        {
+            Lvl[0] = j-i+1;
+            /* ключ C_{v[i],b}, где b -- сосед v[j+1] */
+            pUKeys->a = v[i];
+            if (v[j+1] == 2*v[j])
+            {
+                pUKeys->b = 2*v[j]+1;
+                Hdr[0] = 2;
+            }
+            else
+            {
+                pUKeys->b = 2*v[j];
+                Hdr[0] = 1;
+            }
+            ret = beKeyRep(A, sizeKey, Lvl, Hdr, pUKeys->key);
+            if (ret != ERR_OK) 
+            {
+                memSet(A, 0, sizeof(A));
+                return ret;
+            }
+            pUKeys++;
+            /* ключ C_{v[i],v[j+1]} (для листа не нужен) */
+            if (j+1 == h)
+                break;
+            Hdr[0] = (v[j+1] == 2*v[j]) ? 1 : 2;
+            ret = beKeyRep(A, sizeKey, Lvl, Hdr, A);
+            if (ret != ERR_OK) 
+            {
+                memSet(A, 0, sizeof(A));
+                return ret;
+            }
+        }
+    }
+    
+    memSet(A, 0, sizeof(A));
+    return ERR_OK;
+}
+
+/*
+Чтение номера вершины из сообщения Х_1 (номер занимает size_p байтов).
+*/
+static u32 beLoadId(const u8 *p, u32 size_p)
+{
+    u32 x = 0;
+    memcpy((u8 *) &x, p, size_p);
+    return x;
+}
+
+/*
+Сравнение пар индексов (a, b) с номерами i и j в массиве C.
+*/
+static int beCmpPairs(const u8 *C, u32 size_p, u32 i, u32 j)
+{
+    u32 x, y;
+    x = beLoadId(C + 2*i*size_p, size_p);
+    y = beLoadId(C + 2*j*size_p, size_p);
+    if (x == y)
+    {
+        x = beLoadId(C + (2*i+1)*size_p, size_p);
+        y = beLoadId(C + (2*j+1)*size_p, size_p);
+    }
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+/*
+Обмен пар индексов с номерами i и j в массиве C.
+*/
+static void beSwapPairs(u8 *C, u32 size_p, u32 i, u32 j)
+{
+    u8 tmp[8];
+    memcpy(tmp, C + 2*i*size_p, 2*size_p);
+    memcpy(C + 2*i*size_p, C + 2*j*size_p, 2*size_p);
+    memcpy(C + 2*j*size_p, tmp, 2*size_p);
+}
+
+/*
+Упорядочивание d пар индексов множества-покрытия по возрастанию (a, b)
+(пирамидальная сортировка). Упорядоченный список позволяет получателю 
+находить нужную пару двоичным поиском (см. beFindCover).
+*/
+static void beSortCover(u8 *C, u32 d, u32 size_p)
+{
+    u32 i, j, k, end;
+    /* построим пирамиду */
+    for (i = d/2; i-- > 0;)
+        for (j = i; (k = 2*j+1) < d; j = k)
+        {
+            if (k+1 < d && beCmpPairs(C, size_p, k, k+1) < 0)
+                k++;
+            if (beCmpPairs(C, size_p, j, k) >= 0)
+                break;
+            beSwapPairs(C, size_p, j, k);
+        }
+    /* извлечем максимумы */
+    for (end = d; end-- > 1;)
+    {
+        beSwapPairs(C, size_p, 0, end);
+        for (j = 0; (k = 2*j+1) < end; j = k)
+        {
+            if (k+1 < end && beCmpPairs(C, size_p, k, k+1) < 0)
+                k++;
+            if (beCmpPairs(C, size_p, j, k) >= 0)
+                break;
+            beSwapPairs(C, size_p, j, k);
+        }
+    }
+}
+
+/*
+Поиск в списке пар индексов pKeyInfo (cnt пар), упорядоченном функцией 
+beSortCover, пары (a, b), для которой S_{a,b} содержит лист v[h]. Вершины 
+v[0], v[1], ..., v[h] образуют путь из корня в лист. Кандидатами на роль a
+являются 0 (особый случай) и вершины v[0], ..., v[h-1]: для каждой из них 
+двоичным поиском находятся пары с таким a, что дает O(h log r) операций.
+Возвращается номер найденной пары или cnt, если пара не найдена (список
+не упорядочен или пользователь является запрещенным). Найденная пара всегда 
+корректна, даже если список не упорядочен.
+*/
+static u32 beFindCover(u8 h, const u8 *pKeyInfo, u32 cnt, u32 size_p, 
+    const u32 *v)
+{
+    u32 i, x, lo, hi, mid, a, b, db;
+    
+    for (i = 0; i <= h; i++)
+    {
+        /* x <- кандидат на роль a (глубины i-1) */
+        x = i ? v[i-1] : 0;
+        /* lo <- номер первой пары, для которой a >= x */
+        lo = 0, hi = cnt;
+        while (lo < hi)
+        {
+            mid = lo + (hi-lo)/2;
+            if (beLoadId(pKeyInfo + 2*mid*size_p, size_p) < x)
+                lo = mid+1;
+            else
+                hi = mid;
+        }
+        /* просмотрим пары с a == x */
+        for (; lo < cnt; lo++)
+        {
+            a = beLoadId(pKeyInfo + 2*lo*size_p, size_p);
+            if (a != x)
+                break;
+            b = beLoadId(pKeyInfo + (2*lo+1)*size_p, size_p);
+            if (x == 0)
+            {
+                if (b == 0)
+                    return lo;
+                continue;
+            }
+            /* b --- потомок a, не лежащий на пути в лист? */
+            if ((b <= x) || (b > BE_COUNT_VERTEX(h)))
+                continue;
+            db = beGetDepth(b);
+            if (((b >> (db-i+1)) == x) && (v[db] != b))
+                return lo;
+        }
+    }
+    return cnt;
+}
+
 /*
 Функция на основании множества запрещенных пользователей R формирует сообщение Х_1 
 протокола широковещательного шифрования (pBX) и записывает по адресу pSize размер 
@@ -371,6 +693,7 @@ err_t beFormBMsgX(u8 h, u8 *R, u32 *r, u8 *pBX, u32 *pSize)
     ret = beCreateIdsCover(h, r, R, &d, pBX+size_d);
     if (ret != ERR_OK) 
         return ret;
+    beSortCover(pBX+size_d, d, size_p);
     
     memcpy(pBX, &d, size_d);
     *pSize = size_d+2*d*size_p;
@@ -575,6 +898,35 @@ err_t beFormAMsgY(u32 m, u8 *K, u8 *T, u8 *M, u32 SizeM, u8 *pAY, u32 *pSizeAY)
         return ERR_OK;
 }
 
+/*
+Потоковое формирование и разбор сообщения Y (состояние --- состояние belt-dwp).
+*/
+size_t beAMsgY_keep()
+{
+    return beltDWP_keep();
+}
+
+err_t beFormAMsgYStart(void *state, u32 m, u8 *K, u8 *T)
+{
+    if ((m != 128) && (m != 192) && (m != 256)) 
+        return ERR_INVALID_PARAMETER;
+    if ((state == NULL) || (K == NULL) || (T == NULL)) 
+        return ERR_INVALID_PARAMETER;
+    beltDWPStart(state, K, m/8, T);
+    return ERR_OK;
+}
+
+void beFormAMsgYStep(void *buf, size_t count, void *state)
+{
+    beltDWPStepE(buf, count, state);
+    beltDWPStepA(buf, count, state);
+}
+
+void beFormAMsgYFinish(u8 *pImito, void *state)
+{
+    beltDWPStepG(pImito, state);
+}
+
 /*
 Функция производит для пользователя u разбор сообщения Х_1 (pBX) протокола и формирует на основании 
 массива ключей пользователей pUKeys ключ снятия защиты pDKey и определяет номер e, 
@@ -625,55 +977,66 @@ err_t beAnalyzBMsgX(u8 h, u16 m, u32 u, beUserKey *pUKeys,
         beOffsetUKey[j+1]=beOffsetUKey[j]+h-j;
 
     c = u+n-1;
-    offset = 0;
 
     memSet(Lvl, 0, sizeof(Lvl));
     memSet(Hdr, 0, sizeof(Hdr));
 
-    for (t=0; t<CntKeyInfo; t++)
-    {
-        a = b = 0;
-        memcpy((u8 *) &a, pKeyInfo + offset, size_id); offset += size_id;
-        memcpy((u8 *) &b, pKeyInfo + offset, size_id); offset += size_id;
-
-        if ((a == 0) && (b == 0))
-        { /* шаг 2.1 (особый случай)*/
-            k = 2;
-            e = t;
-            count = 0; /* номер ключа С_{0,0} в наборе всех ключей  */
-            /* проверим корректность набора*/
-            if (((pUKeys+count)->a != a) || ((pUKeys+count)->b != b))
-                return ERR_INTERNAL; /* плохой набор */
-            flag = TRUE;
-            break;
-        }
-        ret  = beCheckLeaf(h, a, b, c);
-        if (ret == ERR_OK)
+    /* вычислим путь из корня в лист c */
+    v[h] = c;
+    for (t=h; t>0; t--)
+        v[t-1] = v[t]/2;
+
+    /* поиск пары в упорядоченном списке */
+    t = beFindCover(h, pKeyInfo, CntKeyInfo, size_p, v);
+
+    /* поиск пары перебором (список не упорядочен или пользователь запрещен) */
+    if (t == CntKeyInfo)
+        for (t=0, offset=0; t<CntKeyInfo; t++)
         {
-            e = t; /* шаг 2.2.a*/
-            if ((b == 2*a) || (b == 2*a+1))
-            { /* шаг 2.2.b*/
-                k = 2; 
-                da = beGetDepth(a);
-                count = beOffsetUKey[da];/* номер ключа С_{a,b} в наборе ключей пользователя*/
-                /* проверим корректность набора*/
-                if (((pUKeys+count)->a != a) || ((pUKeys+count)->b != b))
-                    return ERR_INTERNAL; /* плохой набор */
-                flag = TRUE;
-            }
-            break;
+            a = b = 0;
+            memcpy((u8 *) &a, pKeyInfo + offset, size_p); offset += size_p;
+            memcpy((u8 *) &b, pKeyInfo + offset, size_p); offset += size_p;
+            if ((a == 0) && (b == 0))
+                break;
+            ret  = beCheckLeaf(h, a, b, c);
+            if (ret == ERR_OK)
+                break;
+            else if (ret != ERR_REVOKED) return ret;
         }
-        else if (ret != ERR_REVOKED) return ret;
-    }
 
     /* шаг 3*/
     if (t == CntKeyInfo) return ERR_REVOKED;
 
+    a = b = 0;
+    memcpy((u8 *) &a, pKeyInfo + 2*t*size_p, size_p);
+    memcpy((u8 *) &b, pKeyInfo + 2*t*size_p + size_p, size_p);
+    e = t; /* шаг 2.2.a*/
+    if ((a == 0) && (b == 0))
+    { /* шаг 2.1 (особый случай)*/
+        k = 2;
+        count = 0; /* номер ключа С_{0,0} в наборе всех ключей  */
+        /* проверим корректность набора*/
+        if (((pUKeys+count)->a != a) || ((pUKeys+count)->b != b))
+            return ERR_INTERNAL; /* плохой набор */
+        flag = TRUE;
+    }
+    else if ((b == 2*a) || (b == 2*a+1))
+    { /* шаг 2.2.b*/
+        k = 2; 
+        da = beGetDepth(a);
+        count = beOffsetUKey[da];/* номер ключа С_{a,b} в наборе ключей пользователя*/
+        /* проверим корректность набора*/
+        if (((pUKeys+count)->a != a) || ((pUKeys+count)->b != b))
+            return ERR_INTERNAL; /* плохой набор */
+        flag = TRUE;
+    }
+
+
     if (flag != TRUE)
     { /* шаги 4-10 */
         ea = eb = 0;
-        memcpy((u8 *)&ea, pKeyInfo+e*2*size_id, size_id);
-        memcpy((u8 *)&eb, pKeyInfo+e*2*size_id+size_id, size_id);
+        memcpy((u8 *)&ea, pKeyInfo+e*2*size_p, size_p);
+        memcpy((u8 *)&eb, pKeyInfo+e*2*size_p+size_p, size_p);
         a = beGetDepth(c)-beGetDepth(ea)+1;
         v[a-1] = c;
         for (t=a-1; t>=1; t--)
@@ -839,6 +1202,30 @@ err_t beAnalyzAMsgY(u16 m, u8 *pK, u8 *pAY, u32 SizeAY, u8 *M, u32 *pSizeM)
 
 
 
+/*
+Потоковый разбор сообщения Y.
+*/
+err_t beAnalyzAMsgYStart(void *state, u16 m, u8 *pK, u8 *T)
+{
+    if ((m != 128) && (m != 192) && (m != 256)) 
+        return ERR_INVALID_PARAMETER;
+    if ((state == NULL) || (pK == NULL) || (T == NULL)) 
+        return ERR_INVALID_PARAMETER;
+    beltDWPStart(state, pK, m/8, T);
+    return ERR_OK;
+}
+
+void beAnalyzAMsgYStep(void *buf, size_t count, void *state)
+{
+    beltDWPStepA(buf, count, state);
+    beltDWPStepD(buf, count, state);
+}
+
+err_t beAnalyzAMsgYFinish(const u8 *pImito, void *state)
+{
+    return beltDWPStepV(pImito, state) ? ERR_OK : ERR_BAD_MAC;
+}
+
 /*
 Зашифрование данных по алгоритму BelT в режиме простой замены.
 */
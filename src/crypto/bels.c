@@ -269,9 +269,19 @@ err_t belsShare(octet si[], size_t count, size_t threshold, size_t len,
 	const octet s[], const octet m0[], const octet mi[], 
 	gen_i rng, void* rng_state)
 {
-	size_t n, i;
+	return belsShareBatch(si, 1, count, threshold, len, s, m0, mi, 
+		rng, rng_state);
+}
+
+err_t belsShareBatch(octet si[], size_t num, size_t count, size_t threshold, 
+	size_t len, const octet s[], const octet m0[], const octet mi[], 
+	gen_i rng, void* rng_state)
+{
+	size_t n, i, j;
 	void* state;
+	word* f0;
 	word* f;
+	word* t;
 	word* k;
 	word* c;
 	void* stack;
@@ -281,42 +291,51 @@ err_t belsShare(octet si[], size_t count, size_t threshold, size_t len,
 	// проверить входные данные
 	if ((len != 16 && len != 24 && len != 32) || 
 		threshold == 0 || count < threshold ||
-		!memIsValid(s, len) || !memIsValid(m0, len) || 
-		!memIsValid(mi, len * count) || !memIsValid(si, len * count))
+		!memIsValid(s, len * num) || !memIsValid(m0, len) || 
+		!memIsValid(mi, len * count) || !memIsValid(si, len * count * num))
 		return ERR_BAD_INPUT;
 	EXPECT(belsValM(m0, len) == ERR_OK);
 	// создать состояние
 	n = W_OF_O(len);
-	state = blobCreate(O_OF_W(2 * threshold * n + 1) + 
+	state = blobCreate(O_OF_W(n + (count + 1) * (n + 1) + 
+		2 * threshold * n - n) + 
 		utilMax(2, 
 			ppMul_deep(threshold * n - n, n),
 			ppMod_deep(threshold * n, n + 1)));
 	if (state == 0)
 		return ERR_NOT_ENOUGH_MEMORY;
 	// раскладка состояния
-	f = (word*)state;
-	k = f + n + 1;
+	f0 = (word*)state;
+	f = f0 + n;
+	t = f + count * (n + 1);
+	k = t + n + 1;
 	c = k + threshold * n - n;
 	stack = c + threshold * n;
-	// сгенерировать k
-	rng(k, threshold * len - len, rng_state);
-	wwFrom(k, k, threshold * len - len);
-	// c(x) <- (x^l + m0(x))k(x) + s(x)
-	wwFrom(f, m0, len);
-	ppMul(c, k, threshold * n - n, f, n, stack);
-	wwXor2(c + n, k, threshold * n - n);
-	wwFrom(f, s, len);
-	wwXor2(c, f, n);
-	// цикл по пользователям
+	// f0(x) <- m0(x), f_i(x) <- x^l + mi(x)
+	wwFrom(f0, m0, len);
 	for (i = 0; i < count; ++i)
 	{
-		// f(x) <- x^l + mi(x)
 		EXPECT(belsValM(mi + i * len, len) == ERR_OK);
-		wwFrom(f, mi + i * len, len);
-		f[n] = 1;
-		// si(x) <- c(x) mod f(x)
-		ppMod(f, c, threshold * n, f, n + 1, stack);
-		wwTo(si + i * len, len, f);
+		wwFrom(f + i * (n + 1), mi + i * len, len);
+		f[i * (n + 1) + n] = 1;
+	}
+	// цикл по секретам
+	for (j = 0; j < num; ++j, s += len, si += count * len)
+	{
+		// сгенерировать k
+		rng(k, threshold * len - len, rng_state);
+		wwFrom(k, k, threshold * len - len);
+		// c(x) <- (x^l + m0(x))k(x) + s(x)
+		ppMul(c, k, threshold * n - n, f0, n, stack);
+		wwXor2(c + n, k, threshold * n - n);
+		wwFrom(t, s, len);
+		wwXor2(c, t, n);
+		// цикл по пользователям: si(x) <- c(x) mod (x^l + mi(x))
+		for (i = 0; i < count; ++i)
+		{
+			ppMod(t, c, threshold * n, f + i * (n + 1), n + 1, stack);
+			wwTo(si + i * len, len, t);
+		}
 	}
 	// завершение
 	blobClose(state);
@@ -327,111 +346,289 @@ err_t belsShare(octet si[], size_t count, size_t threshold, size_t len,
 *******************************************************************************
 Восстановление секрета
 
-\todo Организовать вычисления так, чтобы не было медленных (без Карацубы)
-умножений "маленького" многочлена на "большой".
+Пусть f_i(x) = x^l + m_i(x), M(x) = f_1(x) f_2(x)... f_k(x), 
+M_i(x) = M(x) / f_i(x). По китайской теореме об остатках
+	c(x) = \sum_i u_i(x) M_i(x),  u_i(x) = s_i(x) w_i(x) \mod f_i(x),
+где w_i(x) = M_i(x)^{-1} \mod f_i(x) -- коэффициенты Лагранжа. При этом 
+\deg(c) < k l, т.е. c(x) не требуется приводить по модулю M(x). Секрет 
+s(x) = c(x) \mod (x^l + m_0(x)).
+
+Коэффициенты w_i(x) и дерево произведений M(x) зависят только от открытых 
+ключей m_i(x) и рассчитываются один раз (belsRecoverPre):
+-	M_i(x) \mod f_i(x) = \prod_{j != i} (m_i(x) + m_j(x)) \mod f_i(x);
+-	в корне дерева хранится M(x), в левом и правом поддеревьях -- 
+	деревья для первых k_L = k / 2 и последних k_R = k - k_L многочленов f_i(x),
+	в листьях -- многочлены f_i(x).
+
+Сумма c(x) рассчитывается спуском по дереву (belsTreeComb): для узла с 
+поддеревьями L и R
+	c(x) = c_L(x) M_R(x) + c_R(x) M_L(x).
+Умножения многочленов разной длины выполняются по Карацубе (см. ppMul()).
+
+Многочлены f_i(x), w_i(x) и u_i(x) задаются n + 1 словами 
+(см. \ref pp-mod), M(x) для узла с k листьями -- k n + 1 словами.
 *******************************************************************************
 */
 
+static size_t belsTree_keep(size_t k, size_t n)
+{
+	if (k == 1)
+		return n + 1;
+	return k * n + 1 + belsTree_keep(k / 2, n) + belsTree_keep(k - k / 2, n);
+}
+
+static void belsTreeBuild(word tree[], const octet mi[], size_t k, 
+	size_t len, void* stack)
+{
+	const size_t n = W_OF_O(len);
+	const size_t kL = k / 2;
+	const size_t kR = k - kL;
+	word* L;
+	word* R;
+	word* t;
+	// лист: f(x) <- x^l + mi(x)
+	if (k == 1)
+	{
+		wwFrom(tree, mi, len);
+		tree[n] = 1;
+		return;
+	}
+	// поддеревья
+	L = tree + k * n + 1;
+	R = L + belsTree_keep(kL, n);
+	belsTreeBuild(L, mi, kL, len, stack);
+	belsTreeBuild(R, mi + kL * len, kR, len, stack);
+	// M(x) <- M_L(x) M_R(x)
+	t = (word*)stack;
+	stack = t + k * n + 2;
+	ppMul(t, L, kL * n + 1, R, kR * n + 1, stack);
+	ASSERT(t[k * n + 1] == 0);
+	wwCopy(tree, t, k * n + 1);
+}
+
+static size_t belsTreeBuild_deep(size_t k, size_t n)
+{
+	if (k == 1)
+		return 0;
+	return utilMax(3,
+		belsTreeBuild_deep(k / 2, n),
+		belsTreeBuild_deep(k - k / 2, n),
+		O_OF_W(k * n + 2) + 
+			ppMul_deep((k / 2) * n + 1, (k - k / 2) * n + 1));
+}
+
+static void belsTreeComb(word c[], const word u[], const word tree[], 
+	size_t k, size_t n, void* stack)
+{
+	const size_t kL = k / 2;
+	const size_t kR = k - kL;
+	const word* L;
+	const word* R;
+	word* cL;
+	word* cR;
+	word* t;
+	// лист
+	if (k == 1)
+	{
+		wwCopy(c, u, n);
+		return;
+	}
+	// раскладка stack
+	L = tree + k * n + 1;
+	R = L + belsTree_keep(kL, n);
+	cL = (word*)stack;
+	cR = cL + kL * n;
+	stack = cR + kR * n;
+	// cL(x), cR(x)
+	belsTreeComb(cL, u, L, kL, n, stack);
+	belsTreeComb(cR, u + kL * (n + 1), R, kR, n, stack);
+	// c(x) <- cL(x) M_R(x) + cR(x) M_L(x)
+	t = (word*)stack;
+	stack = t + k * n + 1;
+	ppMul(t, cL, kL * n, R, kR * n + 1, stack);
+	ASSERT(t[k * n] == 0);
+	wwCopy(c, t, k * n);
+	ppMul(t, cR, kR * n, L, kL * n + 1, stack);
+	ASSERT(t[k * n] == 0);
+	wwXor2(c, t, k * n);
+}
+
+static size_t belsTreeComb_deep(size_t k, size_t n)
+{
+	if (k == 1)
+		return 0;
+	return O_OF_W(k * n) + 
+		utilMax(3,
+			belsTreeComb_deep(k / 2, n),
+			belsTreeComb_deep(k - k / 2, n),
+			O_OF_W(k * n + 1) + 
+				utilMax(2,
+					ppMul_deep((k / 2) * n, (k - k / 2) * n + 1),
+					ppMul_deep((k - k / 2) * n, (k / 2) * n + 1)));
+}
+
+/*
+	Предвычисления [belsRecoverPre_keep(count, len)]pre:
+	дерево произведений, затем [count * (n + 1)]w (коэффициенты Лагранжа).
+	Возвращается FALSE, если многочлены f_i(x) не являются попарно 
+	взаимно простыми.
+
+	Функция ppInvMod() требует, чтобы модуль f_i(x) не делился на x. 
+	Открытые ключи, для которых belsValM() возвращает ERR_OK, этому условию
+	удовлетворяют. Для других ключей (belsRecover() их не отвергает) 
+	w_i(x) обращается с помощью ppExGCD(). Двоичный алгоритм ppExGCD() 
+	требует, чтобы второй аргумент не делился на x, и этим аргументом 
+	выбирается w_i(x): если fi(x) и w_i(x) делятся на x, то они не 
+	взаимно просты.
+*/
+
+static size_t belsRecoverPre_keep(size_t count, size_t len)
+{
+	const size_t n = W_OF_O(len);
+	return O_OF_W(belsTree_keep(count, n) + count * (n + 1));
+}
+
+static bool_t belsRecoverPre(word pre[], size_t count, size_t len, 
+	const octet mi[], void* stack)
+{
+	const size_t n = W_OF_O(len);
+	size_t i, j;
+	word* w = pre + belsTree_keep(count, n);
+	word* fi = (word*)stack;
+	word* t = fi + n + 1;
+	word* d = t + n + 1;
+	word* u = d + n + 1;
+	word* v = u + n + 1;
+	stack = v + n + 1;
+	// дерево произведений
+	belsTreeBuild(pre, mi, count, len, stack);
+	// коэффициенты Лагранжа
+	for (i = 0; i < count; ++i, w += n + 1)
+	{
+		wwFrom(fi, mi + i * len, len), fi[n] = 1;
+		// w(x) <- \prod_{j != i} (mi(x) + mj(x)) \mod fi(x)
+		wwSetW(w, n + 1, 1);
+		for (j = 0; j < count; ++j)
+			if (j != i)
+			{
+				wwFrom(t, mi + j * len, len), t[n] = 0;
+				wwXor2(t, fi, n);
+				ppMulMod(w, w, t, fi, n + 1, stack);
+			}
+		// w(x) <- w(x)^{-1} \mod fi(x) [w(x) == 0, если \gcd(w, fi) != 1]
+		if (wwTestBit(fi, 0))
+			ppInvMod(w, w, fi, n + 1, stack);
+		// fi(x) делится на x: fi(x) u(x) + w(x) v(x) == d(x)
+		else if (wwTestBit(w, 0))
+		{
+			ppExGCD(d, u, v, fi, n + 1, w, n + 1, stack);
+			if (wwIsW(d, n + 1, 1))
+				ppMod(w, v, n + 1, fi, n + 1, stack);
+			else
+				wwSetZero(w, n + 1);
+		}
+		else
+			wwSetZero(w, n + 1);
+		if (wwIsZero(w, n + 1))
+			return FALSE;
+	}
+	return TRUE;
+}
+
+static size_t belsRecoverPre_deep(size_t count, size_t len)
+{
+	const size_t n = W_OF_O(len);
+	return O_OF_W(5 * n + 5) + 
+		utilMax(5,
+			belsTreeBuild_deep(count, n),
+			ppMulMod_deep(n + 1),
+			ppInvMod_deep(n + 1),
+			ppExGCD_deep(n + 1, n + 1),
+			ppMod_deep(n + 1, n + 1));
+}
+
+/*
+	Восстановление секрета [len]s по частичным секретам [count * len]si 
+	с помощью предвычислений pre.
+*/
+
+static void belsRecoverStep(octet s[], size_t count, size_t len, 
+	const octet si[], const octet m0[], const octet mi[], const word pre[], 
+	void* stack)
+{
+	const size_t n = W_OF_O(len);
+	size_t i;
+	const word* w = pre + belsTree_keep(count, n);
+	word* u = (word*)stack;
+	word* c = u + count * (n + 1);
+	word* f = c + count * n;
+	stack = f + n + 1;
+	// u_i(x) <- s_i(x) w_i(x) \mod f_i(x)
+	for (i = 0; i < count; ++i)
+	{
+		wwFrom(f, mi + i * len, len), f[n] = 1;
+		wwFrom(u + i * (n + 1), si + i * len, len), u[i * (n + 1) + n] = 0;
+		ppMulMod(u + i * (n + 1), u + i * (n + 1), w + i * (n + 1), f, 
+			n + 1, stack);
+	}
+	// c(x) <- \sum_i u_i(x) M_i(x)
+	belsTreeComb(c, u, pre, count, n, stack);
+	// s(x) <- c(x) \mod (x^l + m0(x))
+	wwFrom(f, m0, len), f[n] = 1;
+	ppMod(f, c, count * n, f, n + 1, stack);
+	ASSERT(f[n] == 0);
+	wwTo(s, len, f);
+}
+
+static size_t belsRecoverStep_deep(size_t count, size_t len)
+{
+	const size_t n = W_OF_O(len);
+	return O_OF_W(count * (n + 1) + count * n + n + 1) + 
+		utilMax(3,
+			ppMulMod_deep(n + 1),
+			belsTreeComb_deep(count, n),
+			ppMod_deep(count * n, n + 1));
+}
+
 err_t belsRecover(octet s[], size_t count, size_t len, const octet si[], 
 	const octet m0[], const octet mi[])
 {
-	size_t n, i, deep;
+	return belsRecoverBatch(s, 1, count, len, si, m0, mi);
+}
+
+err_t belsRecoverBatch(octet s[], size_t num, size_t count, size_t len, 
+	const octet si[], const octet m0[], const octet mi[])
+{
+	size_t j;
 	void* state;
-	word* f;
-	word* g;
-	word* d;
-	word* u;
-	word* v;
-	word* c;
-	word* t;
+	word* pre;
 	void* stack;
 	// проверить входные данные
 	if ((len != 16 && len != 24 && len != 32) || count == 0 || 
-		!memIsValid(si, count * len) || !memIsValid(m0, len) || 
-		!memIsValid(mi, len * count) || !memIsValid(s, len))
+		!memIsValid(si, num * count * len) || !memIsValid(m0, len) || 
+		!memIsValid(mi, len * count) || !memIsValid(s, num * len))
 		return ERR_BAD_INPUT;
 	EXPECT(belsValM(m0, len) == ERR_OK);
-	// расчет глубины стека
-	n = W_OF_O(len);
-	deep = utilMax(2, 
-		ppMul_deep(n, n), 
-		ppMod_deep(count * n, n + 1));
-	for (i = 1; i < count; ++i)
-		deep = utilMax(7, 
-			deep, 
-			ppExGCD_deep(n + 1, i * n + 1),
-			ppMul_deep(i * n, i * n),
-			ppMul_deep(2 * i * n, n),
-			ppMul_deep(2 * i * n, n),
-			ppMul_deep(2 * n, i * n),
-			ppMod_deep((2 * i + 1) * n, (i + 1) * n + 1));
-	deep += O_OF_W(
-		n + 1 +			
-		count * n + 1 +
-		(count - 1) * n + 1 +
-		(count - 1) * n + 1 +
-		n + 1 +
-		(2 * count - 1) * n + 
-		MAX2((2 * count - 2) * n, (count + 1) * n));
 	// создать состояние
-	state = blobCreate(deep);
+	state = blobCreate(belsRecoverPre_keep(count, len) + 
+		utilMax(2,
+			belsRecoverPre_deep(count, len),
+			belsRecoverStep_deep(count, len)));
 	if (state == 0)
 		return ERR_NOT_ENOUGH_MEMORY;
 	// раскладка состояния
-	f = (word*)state;
-	g = f + n + 1;
-	d = g + count * n + 1;
-	u = d + (count - 1) * n + 1;
-	v = u + (count - 1) * n + 1;
-	c = v + n + 1;
-	t = c + (2 * count - 1) * n;
-	stack = t + MAX2((2 * count - 2) * n, (count + 1) * n);
-	// [n]c(x) <- s1(x)
-	wwFrom(c, si, len);
-	// [n + 1]g(x) <- x^l + m1(x)
-	wwFrom(g, mi, len), g[n] = 1;
-	// цикл по пользователям
-	for (f[n] = 1, i = 1; i < count; ++i)
+	pre = (word*)state;
+	stack = (octet*)pre + belsRecoverPre_keep(count, len);
+	// предвычисления
+	if (!belsRecoverPre(pre, count, len, mi, stack))
 	{
-		// [n + 1]f(x) <- x^l + mi(x)
-		wwFrom(f, mi + i * len, len);
-		// найти d(x) = \gcd(f(x), g(x)) и коэфф. Безу [i * n]u(x), [n]v(x)
-		ppExGCD(d, u, v, f, n + 1, g, i * n + 1, stack);
-		ASSERT(u[i * n] == 0 && v[n] == 0);
-		// d(x) != 1? 
-		if (wwCmpW(d, i * n + 1, 1) != 0)
-		{
-			blobClose(state);
-			return ERR_BAD_PUBKEY;
-		}
-		// [2 * i * n]c(x) <- u(x)f(x)c(x)
-		// (с помощью [2 * i * n]t)
-		ppMul(t, u, i * n, c, i * n, stack);
-		ppMul(c, t, 2 * i * n, f, n, stack);
-		wwXor2(c + n, t, 2 * i * n);
-		// c(x) <- c(x) + v(x)g(x)si(x)
-		// (с помощью [2 * n]d и [(i + 2) * n]t)
-		wwFrom(t, si + i * len, len);
-		ppMul(d, v, n, t, n, stack);
-		ppMul(t, d, 2 * n, g, i * n, stack);
-		wwXor2(t + i * n, d, 2 * n);
-		wwXor2(c, t, (i + 2) * n);
-		// [(i + 1) * n + 1]g(x) <- g(x)f(x)
-		// (с помощью [(i + 1) * n]t)
-		ppMul(t, f, n, g, i * n, stack);
-		wwXor2(t + n, g, i * n);
-		wwXor2(t + i * n, f, n);
-		wwCopy(g, t, (i + 1) * n);
-		g[(i + 1) * n] = 1;
-		// [(i + 1) * n]c(x) <- c(x) mod g(x)
-		ppMod(c, c, (2 * i + 1) * n, g, (i + 1) * n + 1, stack);
-		ASSERT(c[(i + 1) * n] == 0);
+		blobClose(state);
+		return ERR_BAD_PUBKEY;
 	}
-	// [n]s(x) <- c(x) mod (x^l + m0(x))
-	wwFrom(f, m0, len), f[n] = 1;
-	ppMod(c, c, count * n, f, n + 1, stack);
-	ASSERT(c[n] == 0);
-	wwTo(s, len, c);
+	// восстановление
+	for (j = 0; j < num; ++j)
+		belsRecoverStep(s + j * len, count, len, si + j * count * len, 
+			m0, mi, pre, stack);
 	// завершение
 	blobClose(state);
 	return ERR_OK;
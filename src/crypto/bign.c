@@ -300,6 +300,78 @@ size_t bignStart_keep(size_t l, bign_deep_i deep)
 			deep ? deep(n, f_deep, ec_d, ec_deep) : 0);
 }
 
+/*
+*******************************************************************************
+Квадратный корень
+
+Поскольку p \equiv 3 \mod 4, квадратный корень из a (если он существует) 
+равняется a^e, e = (p + 1) / 4. Для простых bign p = 2^{2l} - c, c мало,
+поэтому e = (2^k - 1) 2^t + e', где e' < 2^t и t невелико (t <= 8 для 
+стандартных кривых). Степень a^{2^k - 1} рассчитывается по цепочке 
+Ито -- Цудзии:
+	a^{2^{2j} - 1} = (a^{2^j - 1})^{2^j} a^{2^j - 1},
+	a^{2^{j + 1} - 1} = (a^{2^j - 1})^2 a,
+затем t младших битов e обрабатываются бинарным методом. Требуется 
+log2(e) возведений в квадрат и около 2 log2(k) + t умножений (против 
+log2(e) / 5 + 16 умножений в qrPower()).
+
+Существование корня функция не проверяет.
+*******************************************************************************
+*/
+
+static void bignSqrt(word b[], const word a[], const qr_o* f, void* stack)
+{
+	const size_t n = f->n;
+	size_t l, k, t, i, j;
+	// переменные в stack
+	word* e = (word*)stack;
+	word* c = e + n;
+	word* d = c + n;
+	stack = d + n;
+	// e <- (p + 1) / 4 = (p >> 2) + 1
+	wwCopy(e, f->mod, n);
+	wwShLo(e, n, 2);
+	zzAddW2(e, n, 1);
+	// e = (2^k - 1) 2^t + e'
+	l = wwBitSize(e, n);
+	for (k = 0; k < l && wwTestBit(e, l - 1 - k); ++k);
+	t = l - k;
+	// c <- a^{2^k - 1}
+	qrCopy(c, a, f);
+	for (i = 0; (k >> i) > 1; ++i);
+	for (j = 1; i--;)
+	{
+		// c <- c^{2^j} c
+		qrCopy(d, c, f);
+		for (l = j; l--;)
+			qrSqr(c, c, f, stack);
+		qrMul(c, c, d, f, stack);
+		j *= 2;
+		// c <- c^2 a
+		if (k >> i & 1)
+		{
+			qrSqr(c, c, f, stack);
+			qrMul(c, c, a, f, stack);
+			++j;
+		}
+	}
+	ASSERT(j == k);
+	// c <- c^{2^t} a^{e'}
+	for (i = t; i--;)
+	{
+		qrSqr(c, c, f, stack);
+		if (wwTestBit(e, i))
+			qrMul(c, c, a, f, stack);
+	}
+	// b <- c
+	qrCopy(b, c, f);
+}
+
+static size_t bignSqrt_deep(size_t n, size_t f_deep)
+{
+	return O_OF_W(3 * n) + f_deep;
+}
+
 /*
 *******************************************************************************
 Проверка параметров
@@ -330,7 +402,7 @@ static size_t bignValParams_deep(size_t n, size_t f_deep, size_t ec_d,
 			ecpIsValid_deep(n, f_deep),
 			ecpIsSafeGroup_deep(n),
 			ecpIsOnA_deep(n, f_deep),
-			qrPower_deep(n, n, f_deep),
+			bignSqrt_deep(n, f_deep),
 			ecHasOrderA_deep(n, ec_d, ec_deep, n));
 }
 
@@ -396,10 +468,7 @@ err_t bignValParams(const bign_params* params)
 		zzJacobi(ec->B, n, ec->f->mod, n, stack) == 1)
 	{
 		// B <- b^{(p + 1) / 4} = \sqrt{b} mod p
-		wwCopy(B, ec->f->mod, n);
-		zzAddW2(B, n, 1);
-		wwShLo(B, n, 2);
-		qrPower(B, ec->B, B, n, ec->f, stack);
+		bignSqrt(B, ec->B, ec->f, stack);
 		// оставшиеся условия
 		if (!wwEq(B, ecY(ec->base, n), n) ||
 			!ecHasOrderA(ec->base, ec, ec->order, n, stack))
@@ -719,6 +788,175 @@ err_t bignDH(octet key[], const bign_params* params, const octet privkey[],
 	return code;
 }
 
+/*
+*******************************************************************************
+Сжатие точек
+
+Сжатое представление точки (x, y) -- это x || (y mod 2): x-координата и 
+октет с четностью y. При восстановлении точки y определяется как 
+квадратный корень из w = x^3 + a x + b (см. bignSqrt()). Корень существует, 
+только если полученная точка лежит на кривой. 
+
+Обращений при восстановлении нет, поэтому пакетное восстановление 
+(bignRecoverPoints) выигрывает только за счет однократного создания 
+описаний поля и кривой.
+*******************************************************************************
+*/
+
+static size_t bignCompressPoint_deep(size_t n, size_t f_deep, size_t ec_d,
+	size_t ec_deep)
+{
+	return O_OF_W(n) + f_deep;
+}
+
+err_t bignCompressPoint(octet xpoint[], const bign_params* params,
+	const octet point[])
+{
+	err_t code;
+	size_t no, n;
+	octet parity;
+	// состояние
+	void* state;
+	ec_o* ec;				/* описание эллиптической кривой */
+	word* t;				/* [n] координата */
+	void* stack;
+	// проверить params
+	if (!memIsValid(params, sizeof(bign_params)))
+		return ERR_BAD_INPUT;
+	if (params->l != 128 && params->l != 192 && params->l != 256)
+		return ERR_BAD_PARAMS;
+	// создать состояние
+	state = blobCreate(bignStart_keep(params->l, bignCompressPoint_deep));
+	if (state == 0)
+		return ERR_NOT_ENOUGH_MEMORY;
+	// старт
+	code = bignStart(state, params);
+	ERR_CALL_HANDLE(code, blobClose(state));
+	ec = (ec_o*)state;
+	// размерности
+	no  = ec->f->no;
+	n = ec->f->n;
+	// проверить входные указатели
+	if (!memIsValid(point, 2 * no) ||
+		!memIsValid(xpoint, no + 1))
+	{
+		blobClose(state);
+		return ERR_BAD_INPUT;
+	}
+	// раскладка состояния
+	t = objEnd(ec, word);
+	stack = t + n;
+	// проверить координаты
+	if (!qrFrom(t, point, ec->f, stack) ||
+		!qrFrom(t, point + no, ec->f, stack))
+	{
+		blobClose(state);
+		return ERR_BAD_POINT;
+	}
+	// xpoint <- x || (y mod 2)
+	parity = point[no] & 1;
+	memMove(xpoint, point, no);
+	xpoint[no] = parity;
+	// завершение
+	blobClose(state);
+	return ERR_OK;
+}
+
+static size_t bignRecoverPoint_deep(size_t n, size_t f_deep, size_t ec_d,
+	size_t ec_deep)
+{
+	return O_OF_W(2 * n) +
+		utilMax(2,
+			bignSqrt_deep(n, f_deep),
+			ecpIsOnA_deep(n, f_deep));
+}
+
+static err_t bignRecoverPointInternal(octet point[], const octet xpoint[],
+	const ec_o* ec, void* stack)
+{
+	const size_t n = ec->f->n;
+	const size_t no = ec->f->no;
+	octet parity;
+	// переменные в stack
+	word* Q = (word*)stack;
+	stack = Q + 2 * n;
+	// загрузить x и четность y
+	parity = xpoint[no];
+	if (parity > 1 || !qrFrom(ecX(Q), xpoint, ec->f, stack))
+		return ERR_BAD_POINT;
+	// y <- \sqrt{x^3 + a x + b}
+	qrSqr(ecY(Q, n), ecX(Q), ec->f, stack);
+	qrAdd(ecY(Q, n), ecY(Q, n), ec->A, ec->f);
+	qrMul(ecY(Q, n), ecY(Q, n), ecX(Q), ec->f, stack);
+	qrAdd(ecY(Q, n), ecY(Q, n), ec->B, ec->f);
+	bignSqrt(ecY(Q, n), ecY(Q, n), ec->f, stack);
+	// Q \in ec?
+	if (!ecpIsOnA(Q, ec, stack))
+		return ERR_BAD_POINT;
+	// выгрузить точку, при необходимости заменив y на -y
+	qrTo(point + no, ecY(Q, n), ec->f, stack);
+	if ((point[no] & 1) != parity)
+	{
+		if (qrIsZero(ecY(Q, n), ec->f))
+			return ERR_BAD_POINT;
+		zmNeg(ecY(Q, n), ecY(Q, n), ec->f);
+		qrTo(point + no, ecY(Q, n), ec->f, stack);
+	}
+	qrTo(point, ecX(Q), ec->f, stack);
+	return ERR_OK;
+}
+
+err_t bignRecoverPoint(octet point[], const bign_params* params,
+	const octet xpoint[])
+{
+	return bignRecoverPoints(point, params, 1, xpoint);
+}
+
+err_t bignRecoverPoints(octet points[], const bign_params* params,
+	size_t count, const octet xpoints[])
+{
+	err_t code;
+	size_t no;
+	size_t i;
+	// состояние
+	void* state;
+	ec_o* ec;				/* описание эллиптической кривой */
+	void* stack;
+	// проверить params
+	if (!memIsValid(params, sizeof(bign_params)))
+		return ERR_BAD_INPUT;
+	if (params->l != 128 && params->l != 192 && params->l != 256)
+		return ERR_BAD_PARAMS;
+	// создать состояние
+	state = blobCreate(bignStart_keep(params->l, bignRecoverPoint_deep));
+	if (state == 0)
+		return ERR_NOT_ENOUGH_MEMORY;
+	// старт
+	code = bignStart(state, params);
+	ERR_CALL_HANDLE(code, blobClose(state));
+	ec = (ec_o*)state;
+	// размерности
+	no  = ec->f->no;
+	// проверить входные указатели [одну точку можно восстанавливать на месте]
+	if (!memIsValid(xpoints, count * (no + 1)) ||
+		!memIsValid(points, 2 * count * no) ||
+		(count > 1 && !memIsDisjoint2(points, 2 * count * no, 
+			xpoints, count * (no + 1))))
+	{
+		blobClose(state);
+		return ERR_BAD_INPUT;
+	}
+	// раскладка состояния
+	stack = objEnd(ec, void);
+	// восстановить точки
+	for (i = 0; i < count && code == ERR_OK; ++i)
+		code = bignRecoverPointInternal(points + 2 * i * no, 
+			xpoints + i * (no + 1), ec, stack);
+	// завершение
+	blobClose(state);
+	return code;
+}
+
 /*
 *******************************************************************************
 Выработка ЭЦП
@@ -1070,14 +1308,16 @@ static size_t bignKeyWrap_deep(size_t n, size_t f_deep, size_t ec_d,
 	size_t ec_deep)
 {
 	return O_OF_W(3 * n) + 32 +
-		utilMax(2,
+		utilMax(4,
 			ecMulA_deep(n, ec_d, ec_deep, n),
-			beltKWP_keep());
+			beltKWP_keep(),
+			bignSqrt_deep(n, f_deep),
+			ecpIsOnA_deep(n, f_deep));
 }
 
-err_t bignKeyWrap(octet token[], const bign_params* params, const octet key[],
-	size_t len, const octet header[16], const octet pubkey[],
-	gen_i rng, void* rng_state)
+static err_t bignKeyWrapInternal(octet token[], const bign_params* params, 
+	const octet key[], size_t len, const octet header[16], 
+	const octet pubkey[], bool_t compressed, gen_i rng, void* rng_state)
 {
 	err_t code;
 	size_t no, n;
@@ -1113,7 +1353,7 @@ err_t bignKeyWrap(octet token[], const bign_params* params, const octet key[],
 	no  = ec->f->no;
 	n = ec->f->n;
 	// проверить входные указатели
-	if (!memIsValid(pubkey, 2 * no) ||
+	if (!memIsValid(pubkey, compressed ? no + 1 : 2 * no) ||
 		!memIsValid(token, 16 + no + len))
 	{
 		blobClose(state);
@@ -1130,13 +1370,32 @@ err_t bignKeyWrap(octet token[], const bign_params* params, const octet key[],
 		blobClose(state);
 		return ERR_BAD_RNG;
 	}
-	// R <- k Q
-	if (!qrFrom(ecX(R), pubkey, ec->f, stack) ||
-		!qrFrom(ecY(R, n), pubkey + no, ec->f, stack))
+	// R <- Q
+	if (!qrFrom(ecX(R), pubkey, ec->f, stack))
 	{
 		blobClose(state);
 		return ERR_BAD_PUBKEY;
 	}
+	if (compressed)
+	{
+		// yR <- \sqrt{xR^3 + a xR + b} [знак yR не влияет на x(k R)]
+		qrSqr(ecY(R, n), ecX(R), ec->f, stack);
+		zmAdd(ecY(R, n), ecY(R, n), ec->A, ec->f);
+		qrMul(ecY(R, n), ecY(R, n), ecX(R), ec->f, stack);
+		zmAdd(ecY(R, n), ecY(R, n), ec->B, ec->f);
+		bignSqrt(ecY(R, n), ecY(R, n), ec->f, stack);
+		if (pubkey[no] > 1 || !ecpIsOnA(R, ec, stack))
+		{
+			blobClose(state);
+			return ERR_BAD_PUBKEY;
+		}
+	}
+	else if (!qrFrom(ecY(R, n), pubkey + no, ec->f, stack))
+	{
+		blobClose(state);
+		return ERR_BAD_PUBKEY;
+	}
+	// R <- k R
 	if (!ecMulA(R, R, ec, k, n, stack))
 	{
 		blobClose(state);
@@ -1169,6 +1428,22 @@ err_t bignKeyWrap(octet token[], const bign_params* params, const octet key[],
 	return ERR_OK;
 }
 
+err_t bignKeyWrap(octet token[], const bign_params* params, const octet key[],
+	size_t len, const octet header[16], const octet pubkey[],
+	gen_i rng, void* rng_state)
+{
+	return bignKeyWrapInternal(token, params, key, len, header, pubkey, 
+		FALSE, rng, rng_state);
+}
+
+err_t bignKeyWrapC(octet token[], const bign_params* params, 
+	const octet key[], size_t len, const octet header[16], 
+	const octet xpubkey[], gen_i rng, void* rng_state)
+{
+	return bignKeyWrapInternal(token, params, key, len, header, xpubkey, 
+		TRUE, rng, rng_state);
+}
+
 /*
 *******************************************************************************
 Разбор токена
@@ -1181,7 +1456,7 @@ static size_t bignKeyUnwrap_deep(size_t n, size_t f_deep, size_t ec_d,
 	return MAX2(O_OF_W(5 * n), 32 + 16) +
 		utilMax(3,
 			beltKWP_keep(),
-			qrPower_deep(n, n, f_deep),
+			bignSqrt_deep(n, f_deep),
 			ecMulA_deep(n, ec_d, ec_deep, n));
 }
 
@@ -1263,10 +1538,7 @@ err_t bignKeyUnwrap(octet key[], const bign_params* params, const octet token[],
 	qrMul(t1, t1, R, ec->f, stack);
 	zmAdd(t1, t1, ec->B, ec->f);
 	// yR <- t1^{(p + 1) / 4}
-	wwCopy(R + n, ec->f->mod, n);
-	zzAddW2(R + n, n, 1);
-	wwShLo(R + n, n, 2);
-	qrPower(R + n, t1, R + n, n, ec->f, stack);
+	bignSqrt(R + n, t1, ec->f, stack);
 	// t2 <- yR^2
 	qrSqr(t2, R + n, ec->f, stack);
 	// (xR, yR) на кривой? t1 == t2?
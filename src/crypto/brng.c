@@ -14,6 +14,7 @@ version 3. See Copyright Notices in bee2/info.h.
 #include "bee2/core/blob.h"
 #include "bee2/core/err.h"
 #include "bee2/core/mem.h"
+#include "bee2/core/mt.h"
 #include "bee2/core/util.h"
 #include "bee2/core/word.h"
 #include "bee2/crypto/belt.h"
@@ -180,6 +181,188 @@ err_t brngCTRRand(void* buf, size_t count, const octet key[32], octet iv[32])
 	return ERR_OK;
 }
 
+/*
+*******************************************************************************
+Многоэкземплярная генерация в режиме CTR
+
+Состояние brng_ctrm_st сопровождается n состояниями brngCTR (экземплярами). 
+Экземпляр i запускается на общем ключе key с синхропосылкой 
+iv_i = belt-hash(iv || <i>_32). Блоки выходных данных вырабатываются 
+экземплярами по очереди: блок с номером b -- экземпляром b mod n. 
+Номер экземпляра, который выработает следующий блок, хранится в поле next.
+
+Экземпляры независимы. Поэтому в функции brngCTRMultiFill() блоки, 
+относящиеся к разным экземплярам, вырабатываются в разных потоках: 
+поток k обслуживает экземпляры i, i mod threads == k. Каждый экземпляр 
+обрабатывает свои блоки в прежнем порядке, и результат не зависит от числа 
+потоков.
+*******************************************************************************
+*/
+
+typedef struct
+{
+	size_t n;			/*< число экземпляров */
+	size_t next;		/*< экземпляр для следующего блока */
+	octet ctr[];		/*< [n * brngCTR_keep()] экземпляры */
+} brng_ctrm_st;
+
+#define brngCTRMultiAt(s, i) ((s)->ctr + (i) * brngCTR_keep())
+
+size_t brngCTRMulti_keep(size_t n)
+{
+	ASSERT(n > 0);
+	return sizeof(brng_ctrm_st) + n * brngCTR_keep();
+}
+
+void brngCTRMultiStart(void* state, const octet key[32], const octet iv[32],
+	size_t n)
+{
+	brng_ctrm_st* s = (brng_ctrm_st*)state;
+	octet iv1[32];
+	octet i1[4];
+	size_t i;
+	ASSERT(n > 0);
+	ASSERT(memIsDisjoint2(s, brngCTRMulti_keep(n), key, 32));
+	ASSERT(iv == 0 || memIsDisjoint2(s, brngCTRMulti_keep(n), iv, 32));
+	s->n = n, s->next = 0;
+	for (i = 0; i < n; ++i)
+	{
+		brng_ctr_st* ctr = (brng_ctr_st*)brngCTRMultiAt(s, i);
+		// iv1 <- belt-hash(iv || <i>_32)
+		memSetZero(iv1, 32);
+		beltHashStart(ctr->state_ex);
+		beltHashStepH(iv ? iv : iv1, 32, ctr->state_ex);
+		i1[0] = (octet)i, i1[1] = (octet)(i >> 8);
+		i1[2] = (octet)(i >> 16), i1[3] = (octet)(i >> 24);
+		beltHashStepH(i1, 4, ctr->state_ex);
+		beltHashStepG(iv1, ctr->state_ex);
+		// запустить экземпляр
+		brngCTRStart(ctr, key, iv1);
+	}
+	memSetZero(iv1, 32);
+}
+
+/*
+	Генерация начальных октетов buf: сначала выдается резерв экземпляра next, 
+	затем вырабатываются полные блоки, пока это можно делать без резерва. 
+	Возвращается число обработанных октетов.
+*/
+static size_t brngCTRMultiHead(void* buf, size_t count, brng_ctrm_st* s)
+{
+	brng_ctr_st* ctr = (brng_ctr_st*)brngCTRMultiAt(s, s->next);
+	size_t t;
+	if (!ctr->reserved)
+		return 0;
+	t = MIN2(ctr->reserved, count);
+	brngCTRStepR(buf, t, ctr);
+	if (!ctr->reserved)
+		s->next = (s->next + 1) % s->n;
+	return t;
+}
+
+static void brngCTRMultiTail(void* buf, size_t count, brng_ctrm_st* s)
+{
+	ASSERT(count < 32);
+	if (count)
+		brngCTRStepR(buf, count, brngCTRMultiAt(s, s->next));
+}
+
+static void brngCTRMultiBlocks(octet* buf, size_t blocks, 
+	const brng_ctrm_st* s, size_t k, size_t threads)
+{
+	size_t i, b;
+	for (i = k; i < s->n; i += threads)
+		for (b = (i + s->n - s->next) % s->n; b < blocks; b += s->n)
+			brngCTRStepR(buf + 32 * b, 32, 
+				(octet*)brngCTRMultiAt(s, i));
+}
+
+void brngCTRMultiStepR(void* buf, size_t count, void* state)
+{
+	brng_ctrm_st* s = (brng_ctrm_st*)state;
+	size_t t;
+	ASSERT(memIsDisjoint2(buf, count, s, brngCTRMulti_keep(s->n)));
+	// резерв
+	t = brngCTRMultiHead(buf, count, s);
+	buf = (octet*)buf + t, count -= t;
+	// полные блоки
+	for (; count >= 32; buf = (octet*)buf + 32, count -= 32)
+	{
+		brngCTRStepR(buf, 32, brngCTRMultiAt(s, s->next));
+		s->next = (s->next + 1) % s->n;
+	}
+	// неполный блок
+	brngCTRMultiTail(buf, count, s);
+}
+
+typedef struct
+{
+	octet* buf;					/*< полные блоки */
+	size_t blocks;				/*< число полных блоков */
+	brng_ctrm_st* s;			/*< состояние */
+	size_t k;					/*< номер потока */
+	size_t threads;				/*< число потоков */
+} brng_ctrm_worker_st;
+
+static void brngCTRMultiWorker(void* arg)
+{
+	brng_ctrm_worker_st* w = (brng_ctrm_worker_st*)arg;
+	brngCTRMultiBlocks(w->buf, w->blocks, w->s, w->k, w->threads);
+}
+
+err_t brngCTRMultiFill(void* buf, size_t count, void* state, size_t threads)
+{
+	brng_ctrm_st* s = (brng_ctrm_st*)state;
+	brng_ctrm_worker_st* w;
+	mt_thrd_t* thrds;
+	size_t blocks, t, i;
+	// проверить входные данные
+	if (threads == 0 || !memIsValid(s, sizeof(brng_ctrm_st)) ||
+		!memIsValid(s, brngCTRMulti_keep(s->n)) ||
+		!memIsValid(buf, count))
+		return ERR_BAD_INPUT;
+	ASSERT(memIsDisjoint2(buf, count, s, brngCTRMulti_keep(s->n)));
+	// резерв
+	t = brngCTRMultiHead(buf, count, s);
+	buf = (octet*)buf + t, count -= t;
+	// полные блоки
+	blocks = count / 32;
+	if (threads > s->n)
+		threads = s->n;
+	if (threads > blocks)
+		threads = blocks;
+	if (threads <= 1)
+		brngCTRMultiBlocks(buf, blocks, s, 0, 1);
+	else
+	{
+		w = (brng_ctrm_worker_st*)blobCreate(
+			threads * (sizeof(brng_ctrm_worker_st) + sizeof(mt_thrd_t)));
+		if (w == 0)
+			return ERR_NOT_ENOUGH_MEMORY;
+		thrds = (mt_thrd_t*)(w + threads);
+		for (i = 0; i < threads; ++i)
+		{
+			w[i].buf = (octet*)buf, w[i].blocks = blocks, w[i].s = s;
+			w[i].k = i, w[i].threads = threads;
+		}
+		for (i = 1; i < threads; ++i)
+			if (!mtThrdCreate(thrds + i, brngCTRMultiWorker, w + i))
+				break;
+		// не удалось запустить потоки: их работа -- в текущем потоке
+		for (t = i; t < threads; ++t)
+			brngCTRMultiWorker(w + t);
+		brngCTRMultiWorker(w);
+		while (--i)
+			mtThrdJoin(thrds + i);
+		blobClose(w);
+	}
+	s->next = (s->next + blocks) % s->n;
+	buf = (octet*)buf + 32 * blocks, count -= 32 * blocks;
+	// неполный блок
+	brngCTRMultiTail(buf, count, s);
+	return ERR_OK;
+}
+
 /*
 *******************************************************************************
 Генерация в режиме HMAC
@@ -822,6 +822,160 @@ err_t dstuRecoverPoint(octet point[], const dstu_params* params,
 	return code;
 }
 
+/*
+*******************************************************************************
+Пакетное восстановление точек
+
+Точки обрабатываются блоками по _DSTU_BATCH штук. В каждом блоке элементы 
+x^2 обращаются одновременно методом Монтгомери (qrInvBatch()). Вместо 
+gf2QSolve() (коэффициент при z равен 1) сразу вычисляется полуслед: 
+при большом числе точек -- с помощью таблиц gf2HTrPre(). Глубина стека 
+не зависит от числа точек, поэтому память под таблицы резервируется всегда, 
+а сами таблицы строятся только при count >= _DSTU_HTR_THRESHOLD.
+*******************************************************************************
+*/
+
+#define _DSTU_BATCH 16
+#define _DSTU_HTR_THRESHOLD 64
+
+static size_t _dstuRecoverPoints_deep(size_t n, size_t f_deep, size_t ec_d, 
+	size_t ec_deep)
+{
+	return O_OF_W(3 * _DSTU_BATCH * n + n) + 
+		gf2HTrPre_keep(B_OF_W(n)) +
+		utilMax(5,
+			qrInvBatch_deep(n, f_deep),
+			gf2Tr_deep(n, f_deep),
+			gf2HTr_deep(n),
+			gf2HTrPre_deep(n, f_deep),
+			f_deep);
+}
+
+err_t dstuRecoverPoints(octet points[], const dstu_params* params, 
+	size_t count, const octet xpoints[])
+{
+	err_t code;
+	size_t m;
+	size_t i, j, k;
+	bool_t use_pre;
+	register word trace;
+	// состояние
+	ec_o* ec;
+	word* x;		/* [_DSTU_BATCH * n] x-координаты */
+	word* t;		/* [_DSTU_BATCH * n] x^2 */
+	word* y;		/* [_DSTU_BATCH * n] x^{-2}, затем y-координаты */
+	word* z;		/* [n] решение z^2 + z == y */
+	word* pre;		/* таблицы полуследа */
+	void* stack;
+	// старт
+	code = _dstuCreateEc(&ec, params, _dstuRecoverPoints_deep);
+	ERR_CALL_CHECK(code);
+	// проверить входные указатели
+	if (!memIsValid(xpoints, count * ec->f->no) || 
+		!memIsValid(points, 2 * count * ec->f->no) ||
+		!memIsDisjoint2(points, 2 * count * ec->f->no, 
+			xpoints, count * ec->f->no))
+	{
+		_dstuCloseEc(ec);
+		return ERR_BAD_INPUT;
+	}
+	// раскладка состояния
+	x = objEnd(ec, word);
+	t = x + _DSTU_BATCH * ec->f->n;
+	y = t + _DSTU_BATCH * ec->f->n;
+	z = y + _DSTU_BATCH * ec->f->n;
+	pre = z + ec->f->n;
+	stack = (octet*)pre + gf2HTrPre_keep(B_OF_W(ec->f->n));
+	// таблицы полуследа
+	use_pre = count >= _DSTU_HTR_THRESHOLD;
+	if (use_pre)
+		gf2HTrPre(pre, ec->f, stack);
+	// обработка блоков
+	for (i = 0; i < count; i += k)
+	{
+		k = MIN2(count - i, _DSTU_BATCH);
+		trace = 0;
+		// загрузить x-координаты, восстановить их первые разряды
+		for (j = 0; j < k; ++j)
+		{
+			word* xj = x + j * ec->f->n;
+			if (!qrFrom(xj, xpoints + (i + j) * ec->f->no, ec->f, stack))
+			{
+				_dstuCloseEc(ec);
+				return ERR_BAD_POINT;
+			}
+			if (!qrIsZero(xj, ec->f))
+			{
+				trace |= (word)wwTestBit(xj, 0) << j;
+				wwSetBit(xj, 0, 0);
+				if (gf2Tr(xj, ec->f, stack) != (bool_t)params->A)
+					wwSetBit(xj, 0, 1);
+			}
+			// x == 0? [обращаемый элемент заменить фиктивным]
+			if (qrIsZero(xj, ec->f))
+				qrSetUnity(t + j * ec->f->n, ec->f);
+			else
+				qrSqr(t + j * ec->f->n, xj, ec->f, stack);
+		}
+		// y[j] <- x[j]^{-2}
+		qrInvBatch(y, t, k, ec->f, stack);
+		// восстановить y-координаты
+		for (j = 0; j < k; ++j)
+		{
+			word* xj = x + j * ec->f->n;
+			word* yj = y + j * ec->f->n;
+			// x == 0?
+			if (qrIsZero(xj, ec->f))
+			{
+				// y <- b^{2^{m - 1}}
+				qrCopy(yj, ec->B, ec->f);
+				for (m = gf2Deg(ec->f); --m;)
+					qrSqr(yj, yj, ec->f, stack);
+				continue;
+			}
+			// y <- x + a + b / x^2
+			qrMul(yj, yj, ec->B, ec->f, stack);
+			gf2Add2(yj, xj, ec->f);
+			if (params->A)
+				wwFlipBit(yj, 0);
+			// Solve[z^2 + z == y]
+			if (gf2Tr(yj, ec->f, stack))
+			{
+				trace = 0;
+				_dstuCloseEc(ec);
+				return ERR_BAD_PARAMS;
+			}
+			if (use_pre)
+				gf2HTr(z, yj, pre, ec->f, stack);
+			else
+			{
+				qrCopy(z, yj, ec->f);
+				for (m = (gf2Deg(ec->f) - 1) / 2; m--;)
+				{
+					qrSqr(z, z, ec->f, stack);
+					qrSqr(z, z, ec->f, stack);
+					gf2Add2(z, yj, ec->f);
+				}
+			}
+			// tr(z) == trace? y <- z * x : y <- (z + 1) * x
+			qrMul(yj, xj, z, ec->f, stack);
+			if (gf2Tr(z, ec->f, stack) != (bool_t)(trace >> j & 1))
+				gf2Add2(yj, xj, ec->f);
+		}
+		// выгрузить точки
+		for (j = 0; j < k; ++j)
+		{
+			octet* point = points + 2 * (i + j) * ec->f->no;
+			qrTo(point, x + j * ec->f->n, ec->f, stack);
+			qrTo(point + ec->f->no, y + j * ec->f->n, ec->f, stack);
+		}
+	}
+	// все нормально
+	trace = 0;
+	_dstuCloseEc(ec);
+	return ERR_OK;
+}
+
 /*
 *******************************************************************************
 Управление ключами
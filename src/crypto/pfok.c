@@ -467,6 +467,12 @@ g^(2) \neq e => g == e или g == -e
 
 err_t pfokGenParams(pfok_params* params, const pfok_seed* seed, 
 	pfok_on_q_i on_q)
+{
+	return pfokGenParamsMT(params, seed, on_q, 1);
+}
+
+err_t pfokGenParamsMT(pfok_params* params, const pfok_seed* seed, 
+	pfok_on_q_i on_q, size_t threads)
 {
 	size_t num = 0;
 	size_t i;
@@ -483,7 +489,7 @@ err_t pfokGenParams(pfok_params* params, const pfok_seed* seed,
 	void* stack;
 	// проверить указатели
 	if (!memIsValid(params, sizeof(pfok_params)) ||
-		!memIsValid(seed, sizeof(pfok_seed)))
+		!memIsValid(seed, sizeof(pfok_seed)) || threads == 0)
 		return ERR_BAD_INPUT;
 	// подготовить params
 	memSetZero(params, sizeof(pfok_params));
@@ -508,13 +514,14 @@ err_t pfokGenParams(pfok_params* params, const pfok_seed* seed,
 	// размерности
 	no = O_OF_B(params->l), n = W_OF_B(params->l);
 	// создать состояние
+	// [глубина priExtendPrimeMT() максимальна при минимальной длине q]
 	state = blobCreate(
 		prngSTB_keep() + O_OF_W(offset) + O_OF_B(lt[i]) + 
 		O_OF_W(n) +	zmMontCreate_keep(no) +
 		utilMax(6,
 			priNextPrimeW_deep(),
-			priExtendPrime_deep(params->l, n, (lt[0] + 3) / 4),
-			priIsSieved_deep((lt[0] + 3) / 4),
+			priExtendPrimeMT_deep(params->l, 1, priBaseSize(), threads),
+			priIsSieved_deep(priBaseSize()),
 			priIsSGPrime_deep(n),
 			zmMontCreate_deep(no), 
 			qrPower_deep(n, n, zmMontCreate_deep(no))));
@@ -548,14 +555,14 @@ err_t pfokGenParams(pfok_params* params, const pfok_seed* seed,
 		else
 		{
 			size_t trials = (i == 0) ? 4 * lt[i] * lt[i] : 4 * lt[i];
-			size_t base_count = (lt[i] + 3) / 4;
-			// потенциальное отступление от Проекта, не влияющее на результат
-			if (base_count > priBaseSize())
-				base_count = priBaseSize();
+			// просеивание по всей факторной базе: отступление от Проекта, 
+			// не влияющее на результат (составные p не проходят тест Демитко),
+			// но сокращающее число тестов Демитко
+			size_t base_count = priBaseSize();
 			// не удается построить новое простое?
-			if (!priExtendPrime(qi + offset, lt[i], 
+			if (!priExtendPrimeMT(qi + offset, lt[i], 
 				qi + offset + W_OF_B(lt[i]), W_OF_B(lt[i + 1]), 
-				trials, base_count, prngSTBStepG, stb_state, stack))
+				trials, base_count, prngSTBStepG, stb_state, threads, stack))
 			{
 				// к предыдущему простому
 				offset += W_OF_B(lt[i++]);
@@ -796,6 +803,181 @@ err_t pfokCalcPubkey(octet pubkey[], const pfok_params* params,
 	return ERR_OK;
 }
 
+/*
+*******************************************************************************
+Предвычисления
+
+Таблица предвычислений начинается с копии долговременных параметров,
+за которой (с выравниванием на границу слова) следует таблица функции
+qrPowerCombPre() для образующего g в кольце Монтгомери.
+*******************************************************************************
+*/
+
+#define pfokPrecompParamsKeep() O_OF_W(W_OF_O(sizeof(pfok_params)))
+
+size_t pfokPrecomp_keep(size_t l, size_t r)
+{
+	return pfokPrecompParamsKeep() + 
+		qrPowerCombPre_keep(W_OF_B(l), W_OF_B(r));
+}
+
+err_t pfokPrecomp(void* pre, const pfok_params* params)
+{
+	size_t no, n;
+	size_t m;
+	// состояние
+	void* state;
+	word* g;				/* [n] образующий */
+	qr_o* qr;				/* описание кольца Монтгомери */
+	void* stack;
+	// проверить params
+	if (!memIsValid(params, sizeof(pfok_params)))
+		return ERR_BAD_INPUT;
+	// работоспособные параметры?
+	if (!pfokIsOperableParams(params))
+		return ERR_BAD_PARAMS;
+	// размерности
+	no = O_OF_B(params->l), n = W_OF_B(params->l);
+	m = W_OF_B(params->r);
+	// проверить остальные входные данные
+	if (!memIsValid(pre, pfokPrecomp_keep(params->l, params->r)))
+		return ERR_BAD_INPUT;
+	// создать состояние
+	state = blobCreate(
+		O_OF_W(n) + zmMontCreate_keep(no) +  
+		utilMax(2,
+			zmMontCreate_deep(no),
+			qrPowerCombPre_deep(n, m, zmMontCreate_deep(no))));
+	if (state == 0)
+		return ERR_NOT_ENOUGH_MEMORY;
+	// раскладка состояния
+	g = (word*)state;
+	qr = (qr_o*)(g + n);
+	stack = (octet*)qr + zmMontCreate_keep(no);
+	// построить кольцо Монтгомери
+	zmMontCreate(qr, params->p, no, params->l + 2, stack);
+	// рассчитать таблицу
+	wwFrom(g, params->g, no);
+	qrPowerCombPre((word*)((octet*)pre + pfokPrecompParamsKeep()), g, m, 
+		qr, stack);
+	memCopy(pre, params, sizeof(pfok_params));
+	// все нормально
+	blobClose(state);
+	return ERR_OK;
+}
+
+err_t pfokGenKeypairPre(octet privkey[], octet pubkey[], const void* pre,
+	gen_i rng, void* rng_state)
+{
+	const pfok_params* params = (const pfok_params*)pre;
+	size_t no, n;
+	size_t mo, m;
+	// состояние
+	void* state;
+	word* x;				/* [m] личный ключ */
+	word* y;				/* [n] открытый ключ */
+	qr_o* qr;				/* описание кольца Монтгомери */
+	void* stack;
+	// проверить params
+	if (!memIsValid(params, sizeof(pfok_params)))
+		return ERR_BAD_INPUT;
+	// работоспособные параметры?
+	if (!pfokIsOperableParams(params))
+		return ERR_BAD_PARAMS;
+	// размерности
+	no = O_OF_B(params->l), n = W_OF_B(params->l);
+	mo = O_OF_B(params->r), m = W_OF_B(params->r);
+	// проверить остальные входные данные
+	if (!memIsValid(pre, pfokPrecomp_keep(params->l, params->r)) ||
+		!memIsValid(privkey, mo) || !memIsValid(pubkey, no) || rng == 0)
+		return ERR_BAD_INPUT;
+	// создать состояние
+	state = blobCreate(
+		O_OF_W(n) + O_OF_W(m) + zmMontCreate_keep(no) +  
+		utilMax(2,
+			zmMontCreate_deep(no),
+			qrPowerComb_deep(n, m, zmMontCreate_deep(no))));
+	if (state == 0)
+		return ERR_NOT_ENOUGH_MEMORY;
+	// раскладка состояния
+	x = (word*)state;
+	y = x + m;
+	qr = (qr_o*)(y + n);
+	stack = (octet*)qr + zmMontCreate_keep(no);
+	// построить кольцо Монтгомери
+	zmMontCreate(qr, params->p, no, params->l + 2, stack);
+	// x <-R {0, 1,..., 2^r - 1}
+	rng(x, mo, rng_state);
+	wwFrom(x, x, mo);
+	wwTrimHi(x, m, params->r);
+	// y <- g^(x)
+	qrPowerComb(y, (const word*)((const octet*)pre + pfokPrecompParamsKeep()),
+		x, m, qr, stack);
+	// выгрузить ключи
+	wwTo(privkey, mo, x);
+	qrTo(pubkey, y, qr, stack);
+	// все нормально
+	blobClose(state);
+	return ERR_OK;
+}
+
+err_t pfokCalcPubkeyPre(octet pubkey[], const void* pre, 
+	const octet privkey[])
+{
+	const pfok_params* params = (const pfok_params*)pre;
+	size_t no, n;
+	size_t mo, m;
+	// состояние
+	void* state;
+	word* x;				/* [m] личный ключ */
+	word* y;				/* [n] открытый ключ */
+	qr_o* qr;				/* описание кольца Монтгомери */
+	void* stack;
+	// проверить params
+	if (!memIsValid(params, sizeof(pfok_params)))
+		return ERR_BAD_INPUT;
+	// работоспособные параметры?
+	if (!pfokIsOperableParams(params))
+		return ERR_BAD_PARAMS;
+	// размерности
+	no = O_OF_B(params->l), n = W_OF_B(params->l);
+	mo = O_OF_B(params->r), m = W_OF_B(params->r);
+	// проверить остальные входные данные
+	if (!memIsValid(pre, pfokPrecomp_keep(params->l, params->r)) ||
+		!memIsValid(privkey, mo) || !memIsValid(pubkey, no))
+		return ERR_BAD_INPUT;
+	// создать состояние
+	state = blobCreate(
+		O_OF_W(n) + O_OF_W(m) + zmMontCreate_keep(no) +  
+		utilMax(2,
+			zmMontCreate_deep(no),
+			qrPowerComb_deep(n, m, zmMontCreate_deep(no))));
+	if (state == 0)
+		return ERR_NOT_ENOUGH_MEMORY;
+	// раскладка состояния
+	x = (word*)state;
+	y = x + m;
+	qr = (qr_o*)(y + n);
+	stack = (octet*)qr + zmMontCreate_keep(no);
+	// построить кольцо Монтгомери
+	zmMontCreate(qr, params->p, no, params->l + 2, stack);
+	// x <- privkey
+	wwFrom(x, privkey, mo);
+	if (wwGetBits(x, params->r, B_OF_W(m) - params->r) != 0)
+	{
+		blobClose(state);
+		return ERR_BAD_PRIVKEY;
+	}
+	// y <- g^(x)
+	qrPowerComb(y, (const word*)((const octet*)pre + pfokPrecompParamsKeep()),
+		x, m, qr, stack);
+	// выгрузить открытый ключ
+	qrTo(pubkey, y, qr, stack);
+	// все нормально
+	blobClose(state);
+	return ERR_OK;
+}
+
 /*
 *******************************************************************************
 Протоколы
@@ -182,6 +182,9 @@ bool_t ecMulA(word b[], const word a[], const ec_o* ec, const word d[],
 	word* pre;			/* pre[i] = (2i + 1)a (naf_count элементов) */
 	// pre
 	ASSERT(ecIsOperable(ec));
+	// специализированный алгоритм?
+	if (ec->mula)
+		return ec->mula(b, a, ec, d, m, stack);
 	// раскладка stack
 	naf = (word*)stack;
 	t = naf + 2 * m + 1;
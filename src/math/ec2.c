@@ -14,6 +14,7 @@ version 3. See Copyright Notices in bee2/info.h.
 #include "bee2/core/mem.h"
 #include "bee2/core/stack.h"
 #include "bee2/core/util.h"
+#include "bee2/core/word.h"
 #include "bee2/math/ec2.h"
 #include "bee2/math/gf2.h"
 #include "bee2/math/pri.h"
@@ -109,6 +110,7 @@ mdbl-2005-dl [Doche-Lange, 2005]. Сложность алгоритма:
 	min_w c2(l, w) <= min_w c3(l, w).
 Поэтому для практически используемых размерностей l (39 <= l)
 первая и третья стратегии являются проигрышными. Реализована только стратегия 2.
+Вместо нее в ecMulA() используется лестница Монтгомери (см. далее).
 
 \todo Реализовать быстрые формулы для особенных B:
 B = 1 (кривые Коблица),	известен \sqrt{B}.
@@ -532,6 +534,162 @@ static size_t ec2SubALD_deep(size_t n, size_t f_deep)
 	return O_OF_W(2 * n) + ec2AddALD_deep(n, f_deep);
 }
 
+/*
+*******************************************************************************
+Лестница Монтгомери
+
+В функции ec2MulAML() реализован алгоритм 3.40 из [Hankerson D., Menezes A., 
+Vanstone S. Guide to Elliptic Curve Cryptography, Springer, 2004] 
+(алгоритм Лопеса -- Дахаба, x-координаты в проективной форме).
+
+Поддерживаются точки R0 = (X1 : Z1) и R1 = (X2 : Z2) такие, что 
+R1 - R0 = P = (x, y). На каждом шаге пара (R0, R1) заменяется либо на 
+(2R0, R0 + R1), либо на (R0 + R1, 2R1). Выбор выполняется условной 
+перестановкой R0 и R1 без ветвлений. Обрабатываются все B_OF_W(m) битов
+кратности, начиная с R0 = O, R1 = P, поэтому последовательность операций
+не зависит от кратности.
+
+Сложение Madd (разность P известна):
+	Z <- (X1 Z2 + X2 Z1)^2, X <- x Z + (X1 Z2)(X2 Z1);
+удвоение Mdouble:
+	Z <- X1^2 Z1^2, X <- X1^4 + B Z1^4.
+Сложность одного шага:
+	6M + 5S + 1*B \approx 6M.
+
+После обработки битов R0 = dP, R1 = (d + 1)P и y-координата dP 
+восстанавливается по формуле
+	y_d = (x + x_d)[(X1 + x Z1)(X2 + x Z2) + (x^2 + y)Z1 Z2] (x Z1 Z2)^{-1} + y.
+Сложность восстановления:
+	1D + 9M + 1S \approx 34M.
+
+Точка P с нулевой x-координатой имеет порядок 2 и обрабатывается отдельно.
+
+Функция ec2MulAML() устанавливается в ec->mula и используется в ecMulA().
+Стратегия 2 из ecMulA() (NAF-окна) требует примерно 
+	5M + 13M / (w + 1) \approx 7.5M 
+на один бит кратности и ее время выполнения зависит от кратности.
+*******************************************************************************
+*/
+
+static void ec2CSwap(word a[], word b[], size_t n, register word mask)
+{
+	register word t;
+	while (n--)
+	{
+		t = (a[n] ^ b[n]) & mask;
+		a[n] ^= t, b[n] ^= t;
+	}
+	t = 0;
+}
+
+static bool_t ec2MulAML(word b[], const word a[], const ec_o* ec,
+	const word d[], size_t m, void* stack)
+{
+	const size_t n = ec->f->n;
+	register word bit;
+	register word swap = 0;
+	size_t i;
+	// переменные в stack
+	word* x1 = (word*)stack;
+	word* z1 = x1 + n;
+	word* x2 = z1 + n;
+	word* z2 = x2 + n;
+	word* t1 = z2 + n;
+	word* t2 = t1 + n;
+	word* t3 = t2 + n;
+	stack = t3 + n;
+	// pre
+	ASSERT(ecIsOperable(ec) && ec->d == 3);
+	ASSERT(ec2SeemsOnA(a, ec));
+	ASSERT(wwIsValid(d, m));
+	ASSERT(a == b || wwIsDisjoint2(a, 2 * n, b, 2 * n));
+	// xa == 0 => 2a == O
+	if (qrIsZero(ecX(a), ec->f))
+	{
+		if (m == 0 || !wwTestBit(d, 0))
+			return FALSE;
+		wwCopy(b, a, 2 * n);
+		return TRUE;
+	}
+	// R0 <- O, R1 <- a
+	qrSetUnity(x1, ec->f);
+	qrSetZero(z1, ec->f);
+	qrCopy(x2, ecX(a), ec->f);
+	qrSetUnity(z2, ec->f);
+	// цикл по битам d
+	for (i = B_OF_W(m); i--;)
+	{
+		bit = (word)wwTestBit(d, i);
+		// R0 <-> R1?
+		swap ^= bit;
+		ec2CSwap(x1, x2, n, WORD_0 - swap);
+		ec2CSwap(z1, z2, n, WORD_0 - swap);
+		swap = bit;
+		// R1 <- R0 + R1 [Madd]
+		qrMul(t1, x1, z2, ec->f, stack);
+		qrMul(t2, x2, z1, ec->f, stack);
+		gf2Add(z2, t1, t2, ec->f);
+		qrSqr(z2, z2, ec->f, stack);
+		qrMul(t1, t1, t2, ec->f, stack);
+		qrMul(x2, ecX(a), z2, ec->f, stack);
+		gf2Add2(x2, t1, ec->f);
+		// R0 <- 2 R0 [Mdouble]
+		qrSqr(t1, x1, ec->f, stack);
+		qrSqr(t2, z1, ec->f, stack);
+		qrMul(z1, t1, t2, ec->f, stack);
+		qrSqr(t1, t1, ec->f, stack);
+		qrSqr(t2, t2, ec->f, stack);
+		qrMul(t2, t2, ec->B, ec->f, stack);
+		gf2Add(x1, t1, t2, ec->f);
+	}
+	ec2CSwap(x1, x2, n, WORD_0 - swap);
+	ec2CSwap(z1, z2, n, WORD_0 - swap);
+	swap = bit = 0;
+	// R0 == O?
+	if (qrIsZero(z1, ec->f))
+		return FALSE;
+	// R1 == O => R0 = -a
+	if (qrIsZero(z2, ec->f))
+	{
+		ec2NegA(b, a, ec);
+		return TRUE;
+	}
+	// t3 <- Z1 Z2
+	qrMul(t3, z1, z2, ec->f, stack);
+	// t1 <- (X1 + x Z1)(X2 + x Z2)
+	qrMul(t1, ecX(a), z1, ec->f, stack);
+	gf2Add2(t1, x1, ec->f);
+	qrMul(t2, ecX(a), z2, ec->f, stack);
+	gf2Add2(t2, x2, ec->f);
+	qrMul(t1, t1, t2, ec->f, stack);
+	// t1 <- t1 + (x^2 + y)Z1 Z2
+	qrSqr(t2, ecX(a), ec->f, stack);
+	gf2Add2(t2, ecY(a, n), ec->f);
+	qrMul(t2, t2, t3, ec->f, stack);
+	gf2Add2(t1, t2, ec->f);
+	// t2 <- (x Z1 Z2)^{-1}
+	qrMul(t3, t3, ecX(a), ec->f, stack);
+	qrInv(t2, t3, ec->f, stack);
+	// x2 <- x_d = X1 / Z1 = X1 x Z2 (x Z1 Z2)^{-1}
+	qrMul(t3, ecX(a), z2, ec->f, stack);
+	qrMul(t3, t3, t2, ec->f, stack);
+	qrMul(x2, x1, t3, ec->f, stack);
+	// t1 <- (x + x_d) t1 (x Z1 Z2)^{-1} + y
+	qrMul(t1, t1, t2, ec->f, stack);
+	gf2Add(t3, ecX(a), x2, ec->f);
+	qrMul(t1, t1, t3, ec->f, stack);
+	gf2Add2(t1, ecY(a, n), ec->f);
+	// b <- (x2, t1)
+	qrCopy(ecX(b), x2, ec->f);
+	qrCopy(ecY(b, n), t1, ec->f);
+	return TRUE;
+}
+
+static size_t ec2MulAML_deep(size_t n, size_t f_deep)
+{
+	return O_OF_W(7 * n) + f_deep;
+}
+
 bool_t ec2CreateLD(ec_o* ec, const qr_o* f, const octet A[], const octet B[],
 	void* stack)
 {
@@ -563,7 +721,9 @@ bool_t ec2CreateLD(ec_o* ec, const qr_o* f, const octet A[], const octet B[],
 	ec->suba = ec2SubALD;
 	ec->dbl = ec2DblLD;
 	ec->dbla = ec2DblALD;
-	ec->deep = utilMax(8,
+	ec->mula = ec2MulAML;
+	ec->deep = utilMax(9,
+		ec2MulAML_deep(f->n, f->deep),
 		ec2ToALD_deep(f->n, f->deep),
 		ec2NegLD_deep(f->n, f->deep),
 		ec2AddLD_deep(f->n, f->deep),
@@ -587,7 +747,8 @@ size_t ec2CreateLD_keep(size_t n)
 
 size_t ec2CreateLD_deep(size_t n, size_t f_deep)
 {
-	return utilMax(8,
+	return utilMax(9,
+		ec2MulAML_deep(n, f_deep),
 		ec2ToALD_deep(n, f_deep),
 		ec2NegLD_deep(n, f_deep),
 		ec2AddLD_deep(n, f_deep),
@@ -53,7 +53,48 @@ http://www.hyperelliptic.org/efd. Там же можно найти соглаш
 	(zmIsIn(ecX(a), (ec)->f) && zmIsIn(ecY(a, (ec)->f->n), (ec)->f))
 
 #define ecpSeemsOn3(a, ec)\
-	(ecpSeemsOnA(a, ec) && zmIsIn(ecZ(a, (ec)->f->n), (ec)->f))
+	((zmIsCrand((ec)->f) || ecpSeemsOnA(a, ec)) &&\
+		zmIsIn(ecZ(a, (ec)->f->n), (ec)->f))
+
+/*
+*******************************************************************************
+Избыточное представление
+
+Если базовое поле построено с редукцией Крэндалла (zmIsCrand() == TRUE),
+то координаты X и Y проективных точек хранятся в избыточном представлении
+(см. zm.h): сложения, вычитания, удвоения и деления на 2 выполняются функциями 
+zzAddModCrand(), zzSubModCrand(), zzDoubleModCrand(), zzHalfModCrand() без 
+сравнений с модулем. Умножения возвращают вычеты, поэтому координаты 
+аффинных точек, которые строятся в ecpToAJ() умножениями, являются вычетами 
+без дополнительной нормализации.
+
+Координата Z всегда хранится как вычет, чтобы макрос ecIsO оставался
+корректным. Элемент a в избыточном представлении равен нулю, если a == 0 
+или a == p.
+
+Для кривых bign (p = 2^l - c) избыточное представление исключает сравнения 
+с модулем в большинстве аддитивных операций функций ecpDblJ(), ecpAddJ(), 
+ecpAddAJ() и др.
+*******************************************************************************
+*/
+
+#define ecpFAdd(c, a, b, f, crand)\
+	((crand) ? zzAddModCrand(c, a, b, (f)->mod, (f)->n) : zmAdd(c, a, b, f))
+
+#define ecpFSub(c, a, b, f, crand)\
+	((crand) ? zzSubModCrand(c, a, b, (f)->mod, (f)->n) : zmSub(c, a, b, f))
+
+#define ecpFNeg(b, a, f, crand)\
+	((crand) ? zzNegModCrand(b, a, (f)->mod, (f)->n) : zmNeg(b, a, f))
+
+#define ecpFDouble(b, a, f, crand)\
+	((crand) ? zzDoubleModCrand(b, a, (f)->mod, (f)->n) : gfpDouble(b, a, f))
+
+#define ecpFHalf(b, a, f, crand)\
+	((crand) ? zzHalfModCrand(b, a, (f)->mod, (f)->n) : gfpHalf(b, a, f))
+
+#define ecpFIsZero(a, f, crand)\
+	(qrIsZero(a, f) || (crand) && wwEq(a, (f)->mod, (f)->n))
 
 /*
 *******************************************************************************
@@ -185,6 +226,7 @@ static size_t ecpToAJ_deep(size_t n, size_t f_deep)
 static void ecpNegJ(word b[], const word a[], const ec_o* ec, void* stack)
 {
 	const size_t n = ec->f->n;
+	const bool_t crand = zmIsCrand(ec->f);
 	// pre
 	ASSERT(ecIsOperable(ec) && ec->d == 3);
 	ASSERT(ecpSeemsOn3(a, ec));
@@ -192,7 +234,7 @@ static void ecpNegJ(word b[], const word a[], const ec_o* ec, void* stack)
 	// xb <- xa
 	qrCopy(ecX(b), ecX(a), ec->f);
 	// yb <- -ya
-	zmNeg(ecY(b, n), ecY(a, n), ec->f);
+	ecpFNeg(ecY(b, n), ecY(a, n), ec->f, crand);
 	// zb <- za
 	qrCopy(ecZ(b, n), ecZ(a, n), ec->f);
 }
@@ -201,6 +243,7 @@ static void ecpNegJ(word b[], const word a[], const ec_o* ec, void* stack)
 static void ecpDblJ(word b[], const word a[], const ec_o* ec, void* stack)
 {
 	const size_t n = ec->f->n;
+	const bool_t crand = zmIsCrand(ec->f);
 	// переменные в stack
 	word* t1 = (word*)stack;
 	word* t2 = t1 + n;
@@ -210,7 +253,7 @@ static void ecpDblJ(word b[], const word a[], const ec_o* ec, void* stack)
 	ASSERT(ecpSeemsOn3(a, ec));
 	ASSERT(wwIsSameOrDisjoint(a, b, 3 * n));
 	// za == 0 или ya == 0? => b <- O
-	if (qrIsZero(ecZ(a, n), ec->f) || qrIsZero(ecY(a, n), ec->f))
+	if (qrIsZero(ecZ(a, n), ec->f) || ecpFIsZero(ecY(a, n), ec->f, crand))
 	{
 		qrSetZero(ecZ(b, n), ec->f);
 		return;
@@ -228,33 +271,33 @@ static void ecpDblJ(word b[], const word a[], const ec_o* ec, void* stack)
 	// t2 <- xa^2
 	qrSqr(t2, ecX(a), ec->f, stack);
 	// t1 <- t1 + t2
-	zmAdd(t1, t1, t2, ec->f);
+	ecpFAdd(t1, t1, t2, ec->f, crand);
 	// t2 <- 2 t2
-	gfpDouble(t2, t2, ec->f);
+	ecpFDouble(t2, t2, ec->f, crand);
 	// t1 <- t1 + t2
-	zmAdd(t1, t1, t2, ec->f);
+	ecpFAdd(t1, t1, t2, ec->f, crand);
 	// yb <- 2 ya
-	gfpDouble(ecY(b, n), ecY(a, n), ec->f);
+	ecpFDouble(ecY(b, n), ecY(a, n), ec->f, crand);
 	// yb <- yb^2
 	qrSqr(ecY(b, n), ecY(b, n), ec->f, stack);
 	// t2 <- yb^2
 	qrSqr(t2, ecY(b, n), ec->f, stack);
 	// t2 <- t2 / 2
-	gfpHalf(t2, t2, ec->f);
+	ecpFHalf(t2, t2, ec->f, crand);
 	// yb <- yb xa
 	qrMul(ecY(b, n), ecY(b, n), ecX(a), ec->f, stack);
 	// xb <- t1^2
 	qrSqr(ecX(b), t1, ec->f, stack);
 	// xb <- xb - yb
-	zmSub(ecX(b), ecX(b), ecY(b, n), ec->f);
+	ecpFSub(ecX(b), ecX(b), ecY(b, n), ec->f, crand);
 	// xb <- xb - yb
-	zmSub(ecX(b), ecX(b), ecY(b, n), ec->f);
+	ecpFSub(ecX(b), ecX(b), ecY(b, n), ec->f, crand);
 	// yb <- yb - xb
-	zmSub(ecY(b, n), ecY(b, n), ecX(b), ec->f);
+	ecpFSub(ecY(b, n), ecY(b, n), ecX(b), ec->f, crand);
 	// yb <- yb t1
 	qrMul(ecY(b, n), ecY(b, n), t1, ec->f, stack);
 	// yb <- yb - t2
-	zmSub(ecY(b, n), ecY(b, n), t2, ec->f);
+	ecpFSub(ecY(b, n), ecY(b, n), t2, ec->f, crand);
 }
 
 static size_t ecpDblJ_deep(size_t n, size_t f_deep)
@@ -266,6 +309,7 @@ static size_t ecpDblJ_deep(size_t n, size_t f_deep)
 static void ecpDblJA3(word b[], const word a[], const ec_o* ec, void* stack)
 {
 	const size_t n = ec->f->n;
+	const bool_t crand = zmIsCrand(ec->f);
 	// переменные в stack
 	word* t1 = (word*)stack;
 	word* t2 = t1 + n;
@@ -275,7 +319,7 @@ static void ecpDblJA3(word b[], const word a[], const ec_o* ec, void* stack)
 	ASSERT(ecpSeemsOn3(a, ec));
 	ASSERT(wwIsSameOrDisjoint(a, b, 3 * n));
 	// za == 0 или ya == 0? => b <- O
-	if (qrIsZero(ecZ(a, n), ec->f) || qrIsZero(ecY(a, n), ec->f))
+	if (qrIsZero(ecZ(a, n), ec->f) || ecpFIsZero(ecY(a, n), ec->f, crand))
 	{
 		qrSetZero(ecZ(b, n), ec->f);
 		return;
@@ -287,37 +331,37 @@ static void ecpDblJA3(word b[], const word a[], const ec_o* ec, void* stack)
 	// zb <- 2 zb
 	gfpDouble(ecZ(b, n), ecZ(b, n), ec->f);
 	// t2 <- xa - t1
-	zmSub(t2, ecX(a), t1, ec->f);
+	ecpFSub(t2, ecX(a), t1, ec->f, crand);
 	// t1 <- xa + t1
-	zmAdd(t1, ecX(a), t1, ec->f);
+	ecpFAdd(t1, ecX(a), t1, ec->f, crand);
 	// t2 <- t1 t2
 	qrMul(t2, t1, t2, ec->f, stack);
 	// t1 <- 2 t2
-	gfpDouble(t1, t2, ec->f);
+	ecpFDouble(t1, t2, ec->f, crand);
 	// t1 <- t1 + t2
-	zmAdd(t1, t1, t2, ec->f);
+	ecpFAdd(t1, t1, t2, ec->f, crand);
 	// yb <- 2 ya
-	gfpDouble(ecY(b, n), ecY(a, n), ec->f);
+	ecpFDouble(ecY(b, n), ecY(a, n), ec->f, crand);
 	// yb <- yb^2
 	qrSqr(ecY(b, n), ecY(b, n), ec->f, stack);
 	// t2 <- yb^2
 	qrSqr(t2, ecY(b, n), ec->f, stack);
 	// t2 <- t2 / 2
-	gfpHalf(t2, t2, ec->f);
+	ecpFHalf(t2, t2, ec->f, crand);
 	// yb <- yb xa
 	qrMul(ecY(b, n), ecY(b, n), ecX(a), ec->f, stack);
 	// xb <- t1^2
 	qrSqr(ecX(b), t1, ec->f, stack);
 	// xb <- xb - yb
-	zmSub(ecX(b), ecX(b), ecY(b, n), ec->f);
+	ecpFSub(ecX(b), ecX(b), ecY(b, n), ec->f, crand);
 	// xb <- xb - yb
-	zmSub(ecX(b), ecX(b), ecY(b, n), ec->f);
+	ecpFSub(ecX(b), ecX(b), ecY(b, n), ec->f, crand);
 	// yb <- yb - xb
-	zmSub(ecY(b, n), ecY(b, n), ecX(b), ec->f);
+	ecpFSub(ecY(b, n), ecY(b, n), ecX(b), ec->f, crand);
 	// yb <- yb t1
 	qrMul(ecY(b, n), ecY(b, n), t1, ec->f, stack);
 	// yb <- yb - t2
-	zmSub(ecY(b, n), ecY(b, n), t2, ec->f);
+	ecpFSub(ecY(b, n), ecY(b, n), t2, ec->f, crand);
 }
 
 static size_t ecpDblJA3_deep(size_t n, size_t f_deep)
@@ -329,6 +373,7 @@ static size_t ecpDblJA3_deep(size_t n, size_t f_deep)
 static void ecpDblAJ(word b[], const word a[], const ec_o* ec, void* stack)
 {
 	const size_t n = ec->f->n;
+	const bool_t crand = zmIsCrand(ec->f);
 	// переменные в stack
 	word* t1 = (word*)stack;
 	word* t2 = t1 + n;
@@ -352,41 +397,41 @@ static void ecpDblAJ(word b[], const word a[], const ec_o* ec, void* stack)
 	// t3 <- t2^2 [YY^2 = YYYY]
 	qrSqr(t3, t2, ec->f, stack);
 	// t2 <- t2 + xa [X1 + YY]
-	zmAdd(t2, t2, ecX(a), ec->f);
+	ecpFAdd(t2, t2, ecX(a), ec->f, crand);
 	// t2 <- t2^2 [(X1 + YY)^2]
 	qrSqr(t2, t2, ec->f, stack);
 	// t2 <- t2 - t1 [(X1 + YY)^2 - XX]
-	zmSub(t2, t2, t1, ec->f);
+	ecpFSub(t2, t2, t1, ec->f, crand);
 	// t2 <- t2 - t3 [(X1 + YY)^2 - XX - YYYY]
-	zmSub(t2, t2, t3, ec->f);
+	ecpFSub(t2, t2, t3, ec->f, crand);
 	// t2 <- 2 t2 [2((X1 + YY)^2 - XX - YYYY) = S]
-	gfpDouble(t2, t2, ec->f);
+	ecpFDouble(t2, t2, ec->f, crand);
 	// t4 <- 2 t1 [2 XX]
-	gfpDouble(t4, t1, ec->f);
+	ecpFDouble(t4, t1, ec->f, crand);
 	// t4 <- t4 + t1 [3 XX]
-	zmAdd(t4, t4, t1, ec->f);
+	ecpFAdd(t4, t4, t1, ec->f, crand);
 	// t4 <- t4 + A [3 XX + A = M]
-	zmAdd(t4, t4, ec->A, ec->f);
+	ecpFAdd(t4, t4, ec->A, ec->f, crand);
 	// t1 <- 2 t2 [2S]
-	gfpDouble(t1, t2, ec->f);
+	ecpFDouble(t1, t2, ec->f, crand);
 	// xb <- t4^2 [M^2]
 	qrSqr(ecX(b), t4, ec->f, stack);
 	// xb <- xb - t1 [M^2 - 2S = T]
-	zmSub(ecX(b), ecX(b), t1, ec->f);
+	ecpFSub(ecX(b), ecX(b), t1, ec->f, crand);
 	// zb <- 2 ya [2Y1]
 	gfpDouble(ecZ(b, n), ecY(a, n), ec->f);
 	// t2 <- t2 - xb [S - T]
-	zmSub(t2, t2, ecX(b), ec->f);
+	ecpFSub(t2, t2, ecX(b), ec->f, crand);
 	// yb <- t4 t2 [M(S - T)]
 	qrMul(ecY(b, n), t4, t2, ec->f, stack);
 	// t3 <- 2 t3 [2 YYYY]
-	gfpDouble(t3, t3, ec->f);
+	ecpFDouble(t3, t3, ec->f, crand);
 	// t3 <- 2 t3 [4 YYYY]
-	gfpDouble(t3, t3, ec->f);
+	ecpFDouble(t3, t3, ec->f, crand);
 	// t3 <- 2 t3 [8 YYYY]
-	gfpDouble(t3, t3, ec->f);
+	ecpFDouble(t3, t3, ec->f, crand);
 	// yb <- yb - t3 [M(S - T) - 8 YYYY]
-	zmSub(ecY(b, n), ecY(b, n), t3, ec->f);
+	ecpFSub(ecY(b, n), ecY(b, n), t3, ec->f, crand);
 }
 
 static size_t ecpDblAJ_deep(size_t n, size_t f_deep)
@@ -399,6 +444,7 @@ static void ecpAddJ(word c[], const word a[], const word b[], const ec_o* ec,
 	void* stack)
 {
 	const size_t n = ec->f->n;
+	const bool_t crand = zmIsCrand(ec->f);
 	// переменные в stack
 	word* t1 = (word*)stack;
 	word* t2 = t1 + n;
@@ -436,21 +482,21 @@ static void ecpAddJ(word c[], const word a[], const word b[], const ec_o* ec,
 	// t4 <- yb t4 [Y2 Z1 Z1Z1 = S2]
 	qrMul(t4, ecY(b, n), t4, ec->f, stack);
 	// zc <- za + zb [Z1 + Z2]
-	zmAdd(ecZ(c, n), ecZ(a, n), ecZ(b, n), ec->f);
+	ecpFAdd(ecZ(c, n), ecZ(a, n), ecZ(b, n), ec->f, crand);
 	// zc <- zc^2 [(Z1 + Z2)^2]
 	qrSqr(ecZ(c, n), ecZ(c, n), ec->f, stack);
 	// zc <- zc - t1 [(Z1 + Z2)^2 - Z1Z1]
-	zmSub(ecZ(c, n), ecZ(c, n), t1, ec->f);
+	ecpFSub(ecZ(c, n), ecZ(c, n), t1, ec->f, crand);
 	// zc <- zc - t2 [(Z1 + Z2)^2 - Z1Z1 - Z2Z2]
-	zmSub(ecZ(c, n), ecZ(c, n), t2, ec->f);
+	ecpFSub(ecZ(c, n), ecZ(c, n), t2, ec->f, crand);
 	// t1 <- xb t1 [X1 Z2Z2 = U2]
 	qrMul(t1, ecX(b), t1, ec->f, stack);
 	// t2 <- xa t2 [X2 Z1Z1 = U1]
 	qrMul(t2, ecX(a), t2, ec->f, stack);
 	// t1 <- t1 - t2 [U2 - U1 = H]
-	zmSub(t1, t1, t2, ec->f);
+	ecpFSub(t1, t1, t2, ec->f, crand);
 	// t1 == 0 => xa zb^2 == xb za^2
-	if (qrIsZero(t1, ec->f))
+	if (ecpFIsZero(t1, ec->f, crand))
 	{
 		// t3 == t4 => ya zb^3 == yb za^3 => a == b => c <- 2a
 		if (qrCmp(t3, t4, ec->f) == 0)
@@ -463,11 +509,11 @@ static void ecpAddJ(word c[], const word a[], const word b[], const ec_o* ec,
 	// zc <- zc t1 [((Z1 + Z2)^2 - Z1Z1 - Z2Z2)H = Z3]
 	qrMul(ecZ(c, n), ecZ(c, n), t1, ec->f, stack);
 	// t4 <- t4 - t3 [S2 - S1]
-	zmSub(t4, t4, t3, ec->f);
+	ecpFSub(t4, t4, t3, ec->f, crand);
 	// t4 <- 2 t4 [2(S2 - S1) = r]
-	gfpDouble(t4, t4, ec->f);
+	ecpFDouble(t4, t4, ec->f, crand);
 	// yc <- 2 t1 [2H]
-	gfpDouble(ecY(c, n), t1, ec->f);
+	ecpFDouble(ecY(c, n), t1, ec->f, crand);
 	// yc <- yc^2 [(2H)^2 = I]
 	qrSqr(ecY(c, n), ecY(c, n), ec->f, stack);
 	// t1 <- t1 yc [H I = J]
@@ -475,23 +521,23 @@ static void ecpAddJ(word c[], const word a[], const word b[], const ec_o* ec,
 	// yc <- t2 yc [U1 I = V]
 	qrMul(ecY(c, n), t2, ecY(c, n), ec->f, stack);
 	// t2 <- 2 yc [2 V]
-	gfpDouble(t2, ecY(c, n), ec->f);
+	ecpFDouble(t2, ecY(c, n), ec->f, crand);
 	// xc <- t4^2 [r^2]
 	qrSqr(ecX(c), t4, ec->f, stack);
 	// xc <- xc - t1 [r^2 - J]
-	zmSub(ecX(c), ecX(c), t1, ec->f);
+	ecpFSub(ecX(c), ecX(c), t1, ec->f, crand);
 	// xc <- xc - t2 [r^2 - J - 2V = X3]
-	zmSub(ecX(c), ecX(c), t2, ec->f);
+	ecpFSub(ecX(c), ecX(c), t2, ec->f, crand);
 	// yc <- yc - xc [V - X3]
-	zmSub(ecY(c, n), ecY(c, n), ecX(c), ec->f);
+	ecpFSub(ecY(c, n), ecY(c, n), ecX(c), ec->f, crand);
 	// yc <- t4 yc [r(V - X3)]
 	qrMul(ecY(c, n), t4, ecY(c, n), ec->f, stack);
 	// t3 <- 2 t3 [2S1]
-	gfpDouble(t3, t3, ec->f);
+	ecpFDouble(t3, t3, ec->f, crand);
 	// t3 <- t3 t1 [2S1 J]
 	qrMul(t3, t3, t1, ec->f, stack);
 	// yc <- yc - t3 [r(V - X3) - 2 S1 J]
-	zmSub(ecY(c, n), ecY(c, n), t3, ec->f);
+	ecpFSub(ecY(c, n), ecY(c, n), t3, ec->f, crand);
 }
 
 static size_t ecpAddJ_deep(size_t n, size_t f_deep)
@@ -507,6 +553,7 @@ static void ecpAddAJ(word c[], const word a[], const word b[], const ec_o* ec,
 	void* stack)
 {
 	const size_t n = ec->f->n;
+	const bool_t crand = zmIsCrand(ec->f);
 	// переменные в stack
 	word* t1 = (word*)stack;
 	word* t2 = t1 + n;
@@ -536,14 +583,14 @@ static void ecpAddAJ(word c[], const word a[], const word b[], const ec_o* ec,
 	// t2 <- t2 yb
 	qrMul(t2, t2, ecY(b, n), ec->f, stack);
 	// t1 <- t1 - xa
-	zmSub(t1, t1, ecX(a), ec->f);
+	ecpFSub(t1, t1, ecX(a), ec->f, crand);
 	// t2 <- t2 - ya
-	zmSub(t2, t2, ecY(a, n), ec->f);
+	ecpFSub(t2, t2, ecY(a, n), ec->f, crand);
 	// t1 == 0?
-	if (qrIsZero(t1, ec->f))
+	if (ecpFIsZero(t1, ec->f, crand))
 	{
 		// t2 == 0 => c <- 2(xb : yb : 1)
-		if (qrIsZero(t2, ec->f))
+		if (ecpFIsZero(t2, ec->f, crand))
 			ecpDblAJ(c, b, ec, stack);
 		// t2 != 0 => c <- O
 		else
@@ -559,21 +606,21 @@ static void ecpAddAJ(word c[], const word a[], const word b[], const ec_o* ec,
 	// t3 <- t3 xa
 	qrMul(t3, t3, ecX(a), ec->f, stack);
 	// t1 <- 2 t3
-	gfpDouble(t1, t3, ec->f);
+	ecpFDouble(t1, t3, ec->f, crand);
 	// xc <- t2^2
 	qrSqr(ecX(c), t2, ec->f, stack);
 	// xc <- xc - t1
-	zmSub(ecX(c), ecX(c), t1, ec->f);
+	ecpFSub(ecX(c), ecX(c), t1, ec->f, crand);
 	// xc <- xc - t4
-	zmSub(ecX(c), ecX(c), t4, ec->f);
+	ecpFSub(ecX(c), ecX(c), t4, ec->f, crand);
 	// t3 <- t3 - xc
-	zmSub(t3, t3, ecX(c), ec->f);
+	ecpFSub(t3, t3, ecX(c), ec->f, crand);
 	// t3 <- t3 t2
 	qrMul(t3, t3, t2, ec->f, stack);
 	// t4 <- t4 ya
 	qrMul(t4, t4, ecY(a, n), ec->f, stack);
 	// yc <- t3 - t4
-	zmSub(ecY(c, n), t3, t4, ec->f);
+	ecpFSub(ecY(c, n), t3, t4, ec->f, crand);
 }
 
 static size_t ecpAddAJ_deep(size_t n, size_t f_deep)
@@ -589,6 +636,7 @@ void ecpSubJ(word c[], const word a[], const word b[], const ec_o* ec,
 	void* stack)
 {
 	const size_t n = ec->f->n;
+	const bool_t crand = zmIsCrand(ec->f);
 	// переменные в stack
 	word* t = (word*)stack;
 	stack = t + 3 * n;
@@ -600,7 +648,7 @@ void ecpSubJ(word c[], const word a[], const word b[], const ec_o* ec,
 	ASSERT(wwIsSameOrDisjoint(b, c, 3 * n));
 	// t <- -b
 	qrCopy(ecX(t), ecX(b), ec->f);
-	zmNeg(ecY(t, n), ecY(b, n), ec->f);
+	ecpFNeg(ecY(t, n), ecY(b, n), ec->f, crand);
 	qrCopy(ecZ(t, n), ecZ(b, n), ec->f);
 	// c <- a + t
 	ecpAddJ(c, a, t, ec, stack);
@@ -616,6 +664,7 @@ static void ecpSubAJ(word c[], const word a[], const word b[], const ec_o* ec,
 	void* stack)
 {
 	const size_t n = ec->f->n;
+	const bool_t crand = zmIsCrand(ec->f);
 	// переменные в stack
 	word* t = (word*)stack;
 	stack = t + 2 * n;
@@ -627,7 +676,7 @@ static void ecpSubAJ(word c[], const word a[], const word b[], const ec_o* ec,
 	ASSERT(b == c || wwIsDisjoint2(b, 2 * n, c, 3 * n));
 	// t <- -b
 	qrCopy(ecX(t), ecX(b), ec->f);
-	zmNeg(ecY(t, n), ecY(b, n), ec->f);
+	ecpFNeg(ecY(t, n), ecY(b, n), ec->f, crand);
 	// c <- a + t
 	ecpAddAJ(c, a, t, ec, stack);
 }
@@ -641,6 +690,7 @@ static size_t ecpSubAJ_deep(size_t n, size_t f_deep)
 static void ecpTplJ(word b[], const word a[], const ec_o* ec, void* stack)
 {
 	const size_t n = ec->f->n;
+	const bool_t crand = zmIsCrand(ec->f);
 	// переменные в stack
 	word* t0 = (word*)stack;
 	word* t1 = t0 + n;
@@ -666,55 +716,55 @@ static void ecpTplJ(word b[], const word a[], const ec_o* ec, void* stack)
 	// t4 <- 3 t0 + A t2^2 [M]
 	qrSqr(t4, t2, ec->f, stack);
 	qrMul(t4, t4, ec->A, ec->f, stack);
-	gfpDouble(t5, t0, ec->f);
-	zmAdd(t5, t0, t5, ec->f);
-	zmAdd(t4, t4, t5, ec->f);
+	ecpFDouble(t5, t0, ec->f, crand);
+	ecpFAdd(t5, t0, t5, ec->f, crand);
+	ecpFAdd(t4, t4, t5, ec->f, crand);
 	// t5 <- t4^2 [MM]
 	qrSqr(t5, t4, ec->f, stack);
 	// t6 <- 6((xa + t1)^2 - t0 - t3) - t5 [E]
-	zmAdd(t6, ecX(a), t1, ec->f);
+	ecpFAdd(t6, ecX(a), t1, ec->f, crand);
 	qrSqr(t6, t6, ec->f, stack);
-	zmSub(t6, t6, t0, ec->f);
-	zmSub(t6, t6, t3, ec->f);
-	gfpDouble(t7, t6, ec->f);
-	zmAdd(t6, t6, t7, ec->f);
-	gfpDouble(t6, t6, ec->f);
-	zmSub(t6, t6, t5, ec->f);
+	ecpFSub(t6, t6, t0, ec->f, crand);
+	ecpFSub(t6, t6, t3, ec->f, crand);
+	ecpFDouble(t7, t6, ec->f, crand);
+	ecpFAdd(t6, t6, t7, ec->f, crand);
+	ecpFDouble(t6, t6, ec->f, crand);
+	ecpFSub(t6, t6, t5, ec->f, crand);
 	// t7 <- t6^2 [EE]
 	qrSqr(t7, t6, ec->f, stack);
 	// t3 <- 16 t3 [T]
-	gfpDouble(t3, t3, ec->f);
-	gfpDouble(t3, t3, ec->f);
-	gfpDouble(t3, t3, ec->f);
-	gfpDouble(t3, t3, ec->f);
+	ecpFDouble(t3, t3, ec->f, crand);
+	ecpFDouble(t3, t3, ec->f, crand);
+	ecpFDouble(t3, t3, ec->f, crand);
+	ecpFDouble(t3, t3, ec->f, crand);
 	// zb <- (za + t6)^2 - t2 - t7
-	zmAdd(ecZ(b, n), ecZ(a, n), t6, ec->f);
+	ecpFAdd(ecZ(b, n), ecZ(a, n), t6, ec->f, crand);
 	qrSqr(ecZ(b, n), ecZ(b, n), ec->f, stack);
 	zmSub(ecZ(b, n), ecZ(b, n), t2, ec->f);
 	zmSub(ecZ(b, n), ecZ(b, n), t7, ec->f);
 	// t2 <- (t4 + t6)^2 - t5 - t7 - t3 [U] 
-	zmAdd(t2, t4, t6, ec->f);
+	ecpFAdd(t2, t4, t6, ec->f, crand);
 	qrSqr(t2, t2, ec->f, stack);
-	zmSub(t2, t2, t5, ec->f);
-	zmSub(t2, t2, t7, ec->f);
-	zmSub(t2, t2, t3, ec->f);
+	ecpFSub(t2, t2, t5, ec->f, crand);
+	ecpFSub(t2, t2, t7, ec->f, crand);
+	ecpFSub(t2, t2, t3, ec->f, crand);
 	// yb <- 8 ya (t2(t3 - t2) - t6 t7)
-	zmSub(t3, t3, t2, ec->f);
+	ecpFSub(t3, t3, t2, ec->f, crand);
 	qrMul(t3, t2, t3, ec->f, stack);
 	qrMul(t6, t6, t7, ec->f, stack);
-	zmSub(t3, t3, t6, ec->f);
+	ecpFSub(t3, t3, t6, ec->f, crand);
 	qrMul(ecY(b, n), ecY(a, n), t3, ec->f, stack);
-	gfpDouble(ecY(b, n), ecY(b, n), ec->f);
-	gfpDouble(ecY(b, n), ecY(b, n), ec->f);
-	gfpDouble(ecY(b, n), ecY(b, n), ec->f);
+	ecpFDouble(ecY(b, n), ecY(b, n), ec->f, crand);
+	ecpFDouble(ecY(b, n), ecY(b, n), ec->f, crand);
+	ecpFDouble(ecY(b, n), ecY(b, n), ec->f, crand);
 	// xb <- 4 (xa t7 - 4 t1 t2)
 	qrMul(t1, t1, t2, ec->f, stack);
-	gfpDouble(t1, t1, ec->f);
-	gfpDouble(t1, t1, ec->f);
+	ecpFDouble(t1, t1, ec->f, crand);
+	ecpFDouble(t1, t1, ec->f, crand);
 	qrMul(ecX(b), ecX(a), t7, ec->f, stack);
-	zmSub(ecX(b), ecX(b), t1, ec->f);
-	gfpDouble(ecX(b), ecX(b), ec->f);
-	gfpDouble(ecX(b), ecX(b), ec->f);
+	ecpFSub(ecX(b), ecX(b), t1, ec->f, crand);
+	ecpFDouble(ecX(b), ecX(b), ec->f, crand);
+	ecpFDouble(ecX(b), ecX(b), ec->f, crand);
 }
 
 static size_t ecpTplJ_deep(size_t n, size_t f_deep)
@@ -726,6 +776,7 @@ static size_t ecpTplJ_deep(size_t n, size_t f_deep)
 static void ecpTplJA3(word b[], const word a[], const ec_o* ec, void* stack)
 {
 	const size_t n = ec->f->n;
+	const bool_t crand = zmIsCrand(ec->f);
 	// переменные в stack
 	word* t1 = (word*)stack;
 	word* t2 = t1 + n;
@@ -746,55 +797,55 @@ static void ecpTplJA3(word b[], const word a[], const ec_o* ec, void* stack)
 	// t3 <- t1^2 [YYYY]
 	qrSqr(t3, t1, ec->f, stack);
 	// t4 <- 3(xa - t2)(xa + t2) [M]
-	zmSub(t4, ecX(a), t2, ec->f);
-	zmAdd(t5, ecX(a), t2, ec->f);
+	ecpFSub(t4, ecX(a), t2, ec->f, crand);
+	ecpFAdd(t5, ecX(a), t2, ec->f, crand);
 	qrMul(t4, t4, t5, ec->f, stack);
-	gfpDouble(t5, t4, ec->f);
-	zmAdd(t4, t4, t5, ec->f);
+	ecpFDouble(t5, t4, ec->f, crand);
+	ecpFAdd(t4, t4, t5, ec->f, crand);
 	// t5 <- t4^2 [MM]
 	qrSqr(t5, t4, ec->f, stack);
 	// t6 <- 12 xa t1 - t5 [E]
 	qrMul(t6, ecX(a), t1, ec->f, stack);
-	gfpDouble(t7, t6, ec->f);
-	zmAdd(t6, t6, t7, ec->f);
-	gfpDouble(t6, t6, ec->f);
-	gfpDouble(t6, t6, ec->f);
-	zmSub(t6, t6, t5, ec->f);
+	ecpFDouble(t7, t6, ec->f, crand);
+	ecpFAdd(t6, t6, t7, ec->f, crand);
+	ecpFDouble(t6, t6, ec->f, crand);
+	ecpFDouble(t6, t6, ec->f, crand);
+	ecpFSub(t6, t6, t5, ec->f, crand);
 	// t7 <- t6^2 [EE]
 	qrSqr(t7, t6, ec->f, stack);
 	// t3 <- 16 t3 [T]
-	gfpDouble(t3, t3, ec->f);
-	gfpDouble(t3, t3, ec->f);
-	gfpDouble(t3, t3, ec->f);
-	gfpDouble(t3, t3, ec->f);
+	ecpFDouble(t3, t3, ec->f, crand);
+	ecpFDouble(t3, t3, ec->f, crand);
+	ecpFDouble(t3, t3, ec->f, crand);
+	ecpFDouble(t3, t3, ec->f, crand);
 	// zb <- (za + t6)^2 - t2 - t7
-	zmAdd(ecZ(b, n), ecZ(a, n), t6, ec->f);
+	ecpFAdd(ecZ(b, n), ecZ(a, n), t6, ec->f, crand);
 	qrSqr(ecZ(b, n), ecZ(b, n), ec->f, stack);
 	zmSub(ecZ(b, n), ecZ(b, n), t2, ec->f);
 	zmSub(ecZ(b, n), ecZ(b, n), t7, ec->f);
 	// t2 <- (t4 + t6)^2 - t5 - t7 - t3 [U] 
-	zmAdd(t2, t4, t6, ec->f);
+	ecpFAdd(t2, t4, t6, ec->f, crand);
 	qrSqr(t2, t2, ec->f, stack);
-	zmSub(t2, t2, t5, ec->f);
-	zmSub(t2, t2, t7, ec->f);
-	zmSub(t2, t2, t3, ec->f);
+	ecpFSub(t2, t2, t5, ec->f, crand);
+	ecpFSub(t2, t2, t7, ec->f, crand);
+	ecpFSub(t2, t2, t3, ec->f, crand);
 	// yb <- 8 ya (t2(t3 - t2) - t6 t7)
-	zmSub(t3, t3, t2, ec->f);
+	ecpFSub(t3, t3, t2, ec->f, crand);
 	qrMul(t3, t2, t3, ec->f, stack);
 	qrMul(t6, t6, t7, ec->f, stack);
-	zmSub(t3, t3, t6, ec->f);
+	ecpFSub(t3, t3, t6, ec->f, crand);
 	qrMul(ecY(b, n), ecY(a, n), t3, ec->f, stack);
-	gfpDouble(ecY(b, n), ecY(b, n), ec->f);
-	gfpDouble(ecY(b, n), ecY(b, n), ec->f);
-	gfpDouble(ecY(b, n), ecY(b, n), ec->f);
+	ecpFDouble(ecY(b, n), ecY(b, n), ec->f, crand);
+	ecpFDouble(ecY(b, n), ecY(b, n), ec->f, crand);
+	ecpFDouble(ecY(b, n), ecY(b, n), ec->f, crand);
 	// xb <- 4 (xa t7 - 4 t1 t2)
 	qrMul(t1, t1, t2, ec->f, stack);
-	gfpDouble(t1, t1, ec->f);
-	gfpDouble(t1, t1, ec->f);
+	ecpFDouble(t1, t1, ec->f, crand);
+	ecpFDouble(t1, t1, ec->f, crand);
 	qrMul(ecX(b), ecX(a), t7, ec->f, stack);
-	zmSub(ecX(b), ecX(b), t1, ec->f);
-	gfpDouble(ecX(b), ecX(b), ec->f);
-	gfpDouble(ecX(b), ecX(b), ec->f);
+	ecpFSub(ecX(b), ecX(b), t1, ec->f, crand);
+	ecpFDouble(ecX(b), ecX(b), ec->f, crand);
+	ecpFDouble(ecX(b), ecX(b), ec->f, crand);
 }
 
 size_t ecpTplJA3_deep(size_t n, size_t f_deep)
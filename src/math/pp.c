@@ -839,6 +839,88 @@ size_t ppAddMulW_deep(size_t n)
 	return O_OF_W(16 + 2);
 }
 
+/*
+*******************************************************************************
+Умножение с помощью инструкции PCLMULQDQ
+
+На платформе x86-64 слова перемножаются инструкцией PCLMULQDQ
+(умножение без переносов), если она поддерживается процессором.
+Поддержка проверяется один раз (cpuid, функция 1, бит 1 регистра ecx),
+результат проверки запоминается.
+
+Многочлены из 2 слов перемножаются по схеме Kara2_1 (3 инструкции).
+Многочлены большей длины разбиваются на части по алгоритму Карацубы
+в функции ppMulEq().
+
+\remark Инструкция выполняется за время, которое не зависит от операндов.
+Поэтому скорость умножения не зависит от секретных данных, как и 
+в программной реализации.
+*******************************************************************************
+*/
+
+#if (B_PER_W == 64) && (defined(__GNUC__) && defined(__x86_64__) ||\
+	defined(_MSC_VER) && defined(_M_X64))
+
+#define PP_CLMUL
+
+#if defined(_MSC_VER)
+	#include <intrin.h>
+	#include <wmmintrin.h>
+	#define _CLMUL_TARGET
+#else
+	#include <cpuid.h>
+	#include <wmmintrin.h>
+	#define _CLMUL_TARGET __attribute__((target("pclmul,sse2")))
+#endif
+
+static bool_t ppHasClmul()
+{
+	static int has = -1;
+	if (has < 0)
+	{
+		u32 info[4];
+#if defined(_MSC_VER)
+		__cpuid((int*)info, 1);
+#else
+		if (!__get_cpuid(1, info, info + 1, info + 2, info + 3))
+			info[2] = 0;
+#endif
+		has = (info[2] & 0x00000002) ? 1 : 0;
+	}
+	return has == 1;
+}
+
+static _CLMUL_TARGET void ppMulClmul1(word c[2], const word a[1], 
+	const word b[1])
+{
+	__m128i t;
+	t = _mm_clmulepi64_si128(_mm_cvtsi64_si128((long long)a[0]), 
+		_mm_cvtsi64_si128((long long)b[0]), 0x00);
+	_mm_storeu_si128((__m128i*)c, t);
+}
+
+static _CLMUL_TARGET void ppMulClmul2(word c[4], const word a[2], 
+	const word b[2])
+{
+	__m128i a0, b0, c0, c1, c2;
+	a0 = _mm_loadu_si128((const __m128i*)a);
+	b0 = _mm_loadu_si128((const __m128i*)b);
+	// c1 || c0 <- a0 b0, c3 || c2 <- a1 b1
+	c0 = _mm_clmulepi64_si128(a0, b0, 0x00);
+	c2 = _mm_clmulepi64_si128(a0, b0, 0x11);
+	// (a0 + a1)(b0 + b1) + a0 b0 + a1 b1
+	c1 = _mm_clmulepi64_si128(_mm_xor_si128(a0, _mm_srli_si128(a0, 8)),
+		_mm_xor_si128(b0, _mm_srli_si128(b0, 8)), 0x00);
+	c1 = _mm_xor_si128(c1, _mm_xor_si128(c0, c2));
+	// c2 || c1 <- c2 || c1 + средняя часть
+	c0 = _mm_xor_si128(c0, _mm_slli_si128(c1, 8));
+	c2 = _mm_xor_si128(c2, _mm_srli_si128(c1, 8));
+	_mm_storeu_si128((__m128i*)c, c0);
+	_mm_storeu_si128((__m128i*)(c + 2), c2);
+}
+
+#endif // PP_CLMUL
+
 /*
 *******************************************************************************
 Умножение в общем случае
@@ -848,7 +930,11 @@ size_t ppAddMulW_deep(size_t n)
 
 Функция _ppMulEq() реализует умножение многочленов одинаковой длины.
 Используются функции из таблицы _mul_funcs либо алгоритм Карацубы
-(возможно усеченный).
+(возможно усеченный). Если поддерживается инструкция PCLMULQDQ, то 
+таблица _mul_funcs не используется: многочлены из 1 и 2 слов 
+перемножаются функциями ppMulClmul1(), ppMulClmul2(), многочлены большей 
+длины -- по алгоритму Карацубы. Глубина стека при этом не превосходит 
+глубины в программной реализации.
 
 deep1(_ppMulEq, n) =
 	max(deep1(_ppMulEq, m), deep1(_ppMulEq, n - m))	+ 4 * m,
@@ -870,9 +956,23 @@ static void ppMulEq(word c[], const word a[], const word b[], size_t n,
 {
 	ASSERT(wwIsDisjoint2(a, n, c, 2 * n));
 	ASSERT(wwIsDisjoint2(b, n, c, 2 * n));
+#ifdef PP_CLMUL
+	// умножение с помощью PCLMULQDQ
+	if (n <= 2 && ppHasClmul())
+	{
+		if (n == 1)
+			ppMulClmul1(c, a, b);
+		else
+			ppMulClmul2(c, a, b);
+	}
+	// умножение многочленов малой длины
+	else if (n < COUNT_OF(_mul_procs) && !ppHasClmul())
+		_mul_procs[n](c, a, b, stack);
+#else
 	// умножение многочленов малой длины
 	if (n < COUNT_OF(_mul_procs))
 		_mul_procs[n](c, a, b, stack);
+#endif
 	// усеченный алгоритм Карацубы, n --- четное
 	else if ((n & 1) == 0)
 	{
@@ -942,17 +1042,27 @@ void ppMul(word c[], const word a[], size_t n, const word b[], size_t m,
 	// длина a меньше длины b?
 	else if (n < m)
 		ppMul(c, b, m, a, n, stack);
-	// длина a больше длины b
+	// длина a больше длины b: a разбивается на блоки длины m
 	else
 	{
 		size_t i;
-		// умножаем части одинаковой длины
+		word* t = (word*)stack;
+		stack = t + 2 * m;
+		// c <- a0 b
 		ppMulEq(c, a, b, m, stack);
-		// готовим старшую часть произведения
 		wwSetZero(c + 2 * m, n - m);
-		// умножаем старшие слова a на b
-		for (i = m; i < n; ++i)
-			c[i + m] ^= ppAddMulW(c + i, b, m, a[i], stack);
+		// c <- c + ai b X^i
+		for (i = m; i + m <= n; i += m)
+		{
+			ppMulEq(t, a + i, b, m, stack);
+			wwXor2(c + i, t, 2 * m);
+		}
+		// неполный последний блок
+		if (i < n)
+		{
+			ppMul(t, a + i, n - i, b, m, stack);
+			wwXor2(c + i, t, n - i + m);
+		}
 	}
 }
 
@@ -975,7 +1085,7 @@ void ppMul(word c[], const word a[], size_t n, const word b[], size_t m,
 
 Глубина стека d(n, m) функции ppMul рассчитывается по следующим правилам:
 	d(n, m) = d(m, n)
-	d(n, m) = max(d(n, n), d(1, 1) + 2), n < m
+	d(n, m) = 2n + max(d(n, n), d(m mod n, n)), n < m
 	d(n, n) = deep(ppMuln), 1 <= n < = 9 [см. пред. таблицу]
 	d(n, n) = d(k, k) + 3k , 10 <= n, k = (n + 1)/2
 
@@ -999,9 +1109,10 @@ size_t ppMul_deep(size_t n, size_t m)
 	if (n > m)
 		return ppMul_deep(m, n);
 	if (n < m)
-		return utilMax(2,
-			ppMul_deep(n, n),
-			ppAddMulW_deep(n));
+		return O_OF_W(2 * n) + 
+			utilMax(2,
+				ppMul_deep(n, n),
+				ppMul_deep(m % n, n));
 	if (n > 9)
 	{
 		size_t k = (n + 1) / 2;
@@ -1539,7 +1650,7 @@ void ppExGCD(word d[], word da[], word db[], const word a[], size_t n,
 			{
 				// da0 <- (da0 + bb) / x, db0 <- (db0 + aa) / x
 				wwXor2(da0, bb, m), wwShLo(da0, m, 1);
-				ASSERT(wwTestBit(db0, 0) == 1);
+				ASSERT(wwTestBit(db0, 0) == wwTestBit(aa, 0));
 				wwXor2(db0, aa, n), wwShLo(db0, n, 1);
 			}
 		// пока v делится на x
@@ -1555,7 +1666,7 @@ void ppExGCD(word d[], word da[], word db[], const word a[], size_t n,
 			{
 				// da <- (da + bb) / x, db <- (db + aa) / x
 				wwXor2(da, bb, m), wwShLo(da, m, 1);
-				ASSERT(wwTestBit(db, 0) == 1);
+				ASSERT(wwTestBit(db, 0) == wwTestBit(aa, 0));
 				wwXor2(db, aa, n), wwShLo(db, n, 1);
 			}
 		// нормализация
@@ -1928,7 +2039,10 @@ bool_t ppIsIrred(const word a[], size_t n, void* stack)
 
 size_t ppIsIrred_deep(size_t n)
 {
-	return O_OF_W(2 * n);
+	return O_OF_W(2 * n) +
+		utilMax(2,
+			ppGCD_deep(n, n),
+			ppSqrMod_deep(n));
 }
 
 /*
@@ -11,7 +11,9 @@ version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
 */
 
+#include "bee2/core/blob.h"
 #include "bee2/core/mem.h"
+#include "bee2/core/mt.h"
 #include "bee2/core/prng.h"
 #include "bee2/core/util.h"
 #include "bee2/core/word.h"
@@ -737,6 +739,61 @@ size_t priIsSGPrime_deep(size_t n)
 			qrPower_deep(n + 1, n, qr_deep));
 }
 
+/*
+*******************************************************************************
+Просеивание
+
+Кандидаты a, a + s, a + 2s,... проверяются на делимость на простые из 
+факторной базы не по одному, а окнами из _sieve_size кандидатов. 
+
+Для каждого простого _base[i] поддерживаются вычет mods[i] = a \mod _base[i]
+первого кандидата окна, вычет steps[i] = s \mod _base[i] шага и обратный
+к нему invs[i] = s^{-1} \mod _base[i] (invs[i] == 0, если steps[i] == 0).
+Кандидат a + js делится на _base[i] тогда и только тогда, когда
+	j \equiv -mods[i] invs[i] \pmod {_base[i]}.
+Поэтому при просеивании окна (функция priSieve()) для каждого простого 
+вычеркиваются кандидаты с номерами j_0, j_0 + _base[i],..., а не 
+пересчитываются вычеты всех кандидатов. При переходе к следующему окну
+(функция priSieveShift()) вычеты mods[i] обновляются инкрементально.
+*******************************************************************************
+*/
+
+static const size_t _sieve_size = 256;
+
+static void priSieve(octet sieve[], const word mods[], const word invs[], 
+	size_t base_count)
+{
+	register size_t i;
+	register size_t j;
+	memSet(sieve, 1, _sieve_size);
+	for (i = 0; i < base_count; ++i)
+	{
+		// шаг кратен _base[i]?
+		if (invs[i] == 0)
+		{
+			if (mods[i] == 0)
+				memSetZero(sieve, _sieve_size);
+			continue;
+		}
+		// j <- -mods[i] * invs[i] \mod _base[i]
+		j = mods[i] == 0 ? 0 :
+			(size_t)((dword)(_base[i] - mods[i]) * invs[i] % _base[i]);
+		// вычеркнуть кандидатов, кратных _base[i]
+		for (; j < _sieve_size; j += (size_t)_base[i])
+			sieve[j] = 0;
+	}
+	i = j = 0;
+}
+
+static void priSieveShift(word mods[], const word steps[], size_t base_count)
+{
+	register size_t i;
+	for (i = 0; i < base_count; ++i)
+		mods[i] = (word)(((dword)(_sieve_size % _base[i]) * steps[i] + 
+			mods[i]) % _base[i]);
+	i = 0;
+}
+
 /*
 *******************************************************************************
 Следующее простое
@@ -777,15 +834,20 @@ bool_t priNextPrime(word p[], const word a[], size_t n, size_t trials,
 {
 	size_t l;
 	size_t i;
-	bool_t base_success;
 	// переменные в stack
 	word* mods;
+	word* steps;
+	word* invs;
+	octet* sieve;
 	// pre
 	ASSERT(wwIsSameOrDisjoint(a, p, n));
 	ASSERT(base_count <= priBaseSize());
 	// раскладка stack
 	mods = (word*)stack;
-	stack = mods + base_count;
+	steps = mods + base_count;
+	invs = steps + base_count;
+	sieve = (octet*)(invs + base_count);
+	stack = sieve + _sieve_size;
 	// l <- битовая длина a
 	l = wwBitSize(a, n);
 	// 0-битовых и 1-битовых простых не существует
@@ -799,39 +861,34 @@ bool_t priNextPrime(word p[], const word a[], size_t n, size_t trials,
 		// при необходимости скоррректировать факторную базу
 		while (base_count > 0 && priBasePrime(base_count - 1) >= p[0])
 			--base_count;
-	// рассчитать остатки от деления на малые простые
+	// рассчитать остатки от деления на малые простые, шаги и обратные 
 	priBaseMod(mods, p, n, base_count);
-	for (i = 0, base_success = TRUE; i < base_count; ++i)
-		if (mods[i] == 0)
-		{
-			base_success = FALSE;
-			break;
-		}
+	for (i = 0; i < base_count; ++i)
+		steps[i] = 2, invs[i] = (_base[i] + 1) / 2;
 	// попытки
-	while (trials == SIZE_MAX || trials--)
+	for (i = 0;; ++i)
 	{
+		// новое окно?
+		if (i == _sieve_size)
+			priSieveShift(mods, steps, base_count), i = 0;
+		if (i == 0)
+			priSieve(sieve, mods, invs, base_count);
+		// исчерпаны попытки?
+		if (trials != SIZE_MAX && trials-- == 0)
+			break;
 		// проверка простоты
-		if (base_success && priRMTest(p, n, iter, stack))
+		if (sieve[i] && priRMTest(p, n, iter, stack))
 			return TRUE;
 		// к следующему кандидату
 		if (zzAddW2(p, n, 2) || wwBitSize(p, n) > l)
-			return FALSE;
-		for (i = 0, base_success = TRUE; i < base_count; ++i)
-		{
-			if (mods[i] < _base[i] - 2)
-				mods[i] += 2;
-			else if (mods[i] == _base[i] - 1)
-				mods[i] = 1;
-			else
-				mods[i] = 0, base_success = FALSE;
-		}
+			break;
 	}
 	return FALSE;
 }
 
 size_t priNextPrime_deep(size_t n, size_t base_count)
 {
-	return base_count * O_PER_W + priRMTest_deep(n);
+	return O_OF_W(3 * base_count) + _sieve_size + priRMTest_deep(n);
 }
 
 /*
@@ -858,46 +915,209 @@ size_t priNextPrime_deep(size_t n, size_t base_count)
 \remark Если t укладывается в m слов, q -- в n слов, то r на шаге 3)
 укладывается в m - n + 1 слов. Действительно, максимальное r получается
 при t = B^m - 1, q = B^{n - 1} и равняется B^{m - n + 1} - 1.
+
+В функции priExtendPrimeMT() кандидаты p, прошедшие просеивание, собираются 
+в пакеты. Кандидаты пакета проверяются по теореме Демитко в threads потоках:
+каждый поток берет очередной непроверенный кандидат в порядке возрастания.
+Если найден подходящий кандидат, то кандидаты с бОльшими номерами больше 
+не проверяются. Возвращается подходящий кандидат с минимальным номером. 
+Поэтому результат не зависит от threads и совпадает с результатом 
+последовательной проверки (threads == 1).
 *******************************************************************************
 */
 
-bool_t priExtendPrime(word p[], size_t l, const word q[], size_t n,
-	size_t trials, size_t base_count, gen_i rng, void* rng_state, void* stack)
+static bool_t priDemytko(const word p[], size_t m, size_t mo, const word r[], 
+	const word q[], size_t n, void* stack)
+{
+	// переменные в stack
+	word* t;
+	word* four;
+	qr_o* qr;
+	// раскладка stack
+	t = (word*)stack;
+	four = t + m;
+	qr = (qr_o*)(four + m);
+	stack = (octet*)qr + zmCreate_keep(mo);
+	// создать кольцо вычетов \mod p
+	wwTo(t, mo, p);
+	zmCreate(qr, (octet*)t, mo, stack);
+	// four <- 4 [в кольце qr]
+	qrAdd(four, qr->unity, qr->unity, qr);
+	qrAdd(four, four, four, qr);
+	// 4^r \mod p != 1?
+	qrPower(t, four, r, m - n + 1, qr, stack);
+	if (qrCmp(t, qr->unity, qr) == 0)
+		return FALSE;
+	// (4^r)^q \mod p == 1?
+	qrPower(t, t, q, n, qr, stack);
+	return qrCmp(t, qr->unity, qr) == 0;
+}
+
+static size_t priDemytko_deep(size_t m, size_t mo)
+{
+	const size_t qr_deep = zmCreate_deep(mo);
+	return O_OF_W(2 * m) + zmCreate_keep(mo) +
+		utilMax(2,
+			qr_deep,
+			qrPower_deep(m, m, qr_deep));
+}
+
+typedef struct
+{
+	const word* ps;		/*!< кандидаты p */
+	const word* rs;		/*!< соответствующие r */
+	const word* q;		/*!< базовое простое */
+	size_t m;			/*!< длина p в словах */
+	size_t mo;			/*!< длина p в октетах */
+	size_t n;			/*!< длина q в словах */
+	size_t count;		/*!< число кандидатов */
+	size_t next;		/*!< номер очередного кандидата */
+	size_t found;		/*!< номер подходящего кандидата */
+	mt_mtx_t mtx;		/*!< мьютекс */
+} pri_batch_st;
+
+typedef struct
+{
+	pri_batch_st* batch;	/*!< пакет */
+	void* stack;			/*!< стек потока */
+} pri_worker_st;
+
+static void priBatchWorker(void* arg)
+{
+	pri_batch_st* b = ((pri_worker_st*)arg)->batch;
+	void* stack = ((pri_worker_st*)arg)->stack;
+	size_t i;
+	while (1)
+	{
+		// i <- номер очередного кандидата
+		mtMtxLock(&b->mtx);
+		i = b->next++;
+		// кандидаты исчерпаны или уже найден кандидат с меньшим номером?
+		if (i >= b->count || i >= b->found)
+		{
+			mtMtxUnlock(&b->mtx);
+			break;
+		}
+		mtMtxUnlock(&b->mtx);
+		// проверить кандидата
+		if (priDemytko(b->ps + i * b->m, b->m, b->mo, 
+			b->rs + i * (b->m - b->n + 1), b->q, b->n, stack))
+		{
+			mtMtxLock(&b->mtx);
+			if (i < b->found)
+				b->found = i;
+			mtMtxUnlock(&b->mtx);
+		}
+	}
+}
+
+static bool_t priBatchTest(word p[], pri_batch_st* b, pri_worker_st* w, 
+	mt_thrd_t* thrds, size_t threads)
+{
+	size_t i;
+	// пустой пакет?
+	if (b->count == 0)
+		return FALSE;
+	b->next = 0, b->found = SIZE_MAX;
+	// запустить потоки
+	for (i = 1; i < threads && i < b->count; ++i)
+		if (!mtThrdCreate(thrds + i, priBatchWorker, w + i))
+			break;
+	// работать в текущем потоке
+	priBatchWorker(w);
+	// дождаться завершения потоков
+	while (--i)
+		mtThrdJoin(thrds + i);
+	// обработать результаты
+	i = b->found, b->count = 0;
+	if (i == SIZE_MAX)
+		return FALSE;
+	wwCopy(p, b->ps + i * b->m, b->m);
+	return TRUE;
+}
+
+static size_t priBatchSize(size_t threads)
+{
+	return threads == 1 ? 1 : 4 * threads;
+}
+
+bool_t priExtendPrimeMT(word p[], size_t l, const word q[], size_t n,
+	size_t trials, size_t base_count, gen_i rng, void* rng_state, 
+	size_t threads, void* stack)
 {
 	const size_t m = W_OF_B(l);
 	const size_t mo = O_OF_B(l);
 	size_t i;
+	bool_t ret = FALSE;
+	void* state = 0;
 	// переменные в stack
 	word* r;
 	word* t;
-	word* four;
 	word* mods;
 	word* mods1;
-	qr_o* qr;
+	word* invs;
+	octet* sieve;
+	word* ps;
+	word* rs;
+	pri_batch_st* b;
+	pri_worker_st* w;
+	mt_thrd_t* thrds;
 	// pre
 	ASSERT(wwIsDisjoint2(q, n, p, m));
 	ASSERT(zzIsOdd(q, n) && wwCmpW(q, n, 3) >= 0);
 	ASSERT(wwBitSize(q, n) + 1 <= l && l <= 2 * wwBitSize(q, n));
 	ASSERT(base_count <= priBaseSize());
 	ASSERT(rng != 0);
+	ASSERT(threads > 0);
 	// подкорректировать n
 	n = wwWordSize(q, n);
 	// раскладка stack
 	r = (word*)stack;
 	t = r + m - n + 1;
-	four = t + m + 1;
-	mods = four + m;
+	mods = t + m + 1;
 	mods1 = mods + base_count;
-	qr = (qr_o*)(mods1 + base_count);
-	stack = (octet*)qr + zmCreate_keep(mo);
-	// малое p?
-	if (l < B_PER_W)
-		// при необходимости уменьшить факторную базу
+	invs = mods1 + base_count;
+	sieve = (octet*)(invs + base_count);
+	ps = (word*)(sieve + _sieve_size);
+	rs = ps + priBatchSize(threads) * m;
+	b = (pri_batch_st*)(rs + priBatchSize(threads) * (m - n + 1));
+	w = (pri_worker_st*)(b + 1);
+	thrds = (mt_thrd_t*)(w + threads);
+	stack = thrds + threads;
+	// подготовить потоки
+	if (threads > 1 && mtMtxCreate(&b->mtx))
+	{
+		state = blobCreate((threads - 1) * priDemytko_deep(m, mo));
+		if (state == 0)
+			mtMtxClose(&b->mtx);
+	}
+	if (state == 0)
+	{
+		threads = 1;
+		VERIFY(mtMtxCreate(&b->mtx));
+	}
+	for (i = 0; i < threads; ++i)
+		w[i].batch = b, w[i].stack = i ? 
+			(octet*)state + (i - 1) * priDemytko_deep(m, mo) : stack;
+	b->ps = ps, b->rs = rs, b->q = q;
+	b->m = m, b->mo = mo, b->n = n;
+	b->count = 0;
+	// малое p? при необходимости уменьшить факторную базу
+	if (l <= B_PER_W)
 		while (base_count > 0 && 
 			priBasePrime(base_count - 1) > WORD_BIT_POS(l - 1))
 			--base_count;
+	// рассчитать вычеты 2q по малым модулям и обратные к ним
+	priBaseMod(mods1, q, n, base_count);
+	for (i = 0; i < base_count; ++i)
+	{
+		if ((mods1[i] += mods1[i]) >= _base[i])
+			mods1[i] -= _base[i];
+		invs[i] = mods1[i] == 0 ? 0 : 
+			zzPowerModW(mods1[i], _base[i] - 2, _base[i], stack);
+	}
 	// попытки
-	while (trials == SIZE_MAX || trials--)
+	while (!ret && (trials == SIZE_MAX || trials--))
 	{
 		// t <-R [2^{l - 2}, 2^{l - 1})
 		rng(t, mo, rng_state);
@@ -917,67 +1137,80 @@ bool_t priExtendPrime(word p[], size_t l, const word q[], size_t n,
 		wwShHi(p, m, 1);
 		++p[0];
 		ASSERT(wwBitSize(p, m) == l);
-		// рассчитать вычеты p, 2q по малым модулям
+		// рассчитать вычеты p по малым модулям
 		priBaseMod(mods, p, m, base_count);
-		priBaseMod(mods1, q, n, base_count);
-		for (i = 0; i < base_count; ++i)
-			if ((mods1[i] += mods1[i]) >= _base[i])
-				mods1[i] -= _base[i];
 		// проверка простоты
-		while (1)
+		for (i = 0;; ++i)
 		{
-			// p делится на малые простые?
-			for (i = 0; i < base_count; ++i)
-				if (mods[i] == 0)
-					break;
-			// не делится: тест Демитко
-			if (i == base_count)
+			// новое окно?
+			if (i == _sieve_size)
+				priSieveShift(mods, mods1, base_count), i = 0;
+			if (i == 0)
+				priSieve(sieve, mods, invs, base_count);
+			// p не делится на малые простые: в пакет
+			if (sieve[i])
 			{
-				// создать кольцо вычетов \mod p
-				wwTo(t, mo, p);
-				zmCreate(qr, (octet*)t, mo, stack);
-				// four <- 4 [в кольце qr]
-				qrAdd(four, qr->unity, qr->unity, qr);
-				qrAdd(four, four, four, qr);
-				// 4^r \mod p != 1?
-				qrPower(t, four, r, m - n + 1, qr, stack);
-				if (qrCmp(t, qr->unity, qr) != 0)
-				{
-					// (4^r)^q \mod p == 1?
-					qrPower(t, t, q, n, qr, stack);
-					if (qrCmp(t, qr->unity, qr) == 0)
-						return TRUE;
-				}
+				wwCopy(ps + b->count * m, p, m);
+				wwCopy(rs + b->count * (m - n + 1), r, m - n + 1);
+				// пакет заполнен: тест Демитко
+				if (++b->count == priBatchSize(threads) &&
+					(ret = priBatchTest(p, b, w, thrds, threads)))
+					break;
 			}
 			// p <- p + 2q, переполнение?
 			if (zzAddW2(p + n, m - n, zzAdd2(p, q, n)) ||
 				zzAddW2(p + n, m - n, zzAdd2(p, q, n)) ||
 				wwBitSize(p, m) > l)
+			{
+				ret = priBatchTest(p, b, w, thrds, threads);
 				break;
-			// r <- r + 1, t <- t + q, пересчитать mods
+			}
+			// r <- r + 1
 			zzAddW2(r, m - n + 1, 1);
-			zzAddW2(t + n, m - n, zzAdd2(t, q, n));
-			for (i = 0; i < base_count; ++i)
-				if ((mods[i] += mods1[i]) >= _base[i])
-					mods[i] -= _base[i];
 			// к следующей попытке
 			if (trials != SIZE_MAX && trials-- == 0)
-				return FALSE;
+			{
+				ret = priBatchTest(p, b, w, thrds, threads);
+				trials = 0;
+				break;
+			}
 		}
+		// попытки исчерпаны?
+		if (trials == 0)
+			break;
 	}
-	return FALSE;
+	// завершение
+	mtMtxClose(&b->mtx);
+	blobClose(state);
+	return ret;
 }
 
-size_t priExtendPrime_deep(size_t l, size_t n, size_t base_count)
+size_t priExtendPrimeMT_deep(size_t l, size_t n, size_t base_count, 
+	size_t threads)
 {
 	const size_t m = W_OF_B(l);
 	const size_t mo = O_OF_B(l);
-	const size_t qr_deep = zmCreate_deep(mo);
 	ASSERT(m >= n);
-	return O_OF_W(m - n + 1 + m + 1 + m + 2 * base_count) + zmCreate_keep(mo) +
+	ASSERT(threads > 0);
+	return O_OF_W(m - n + 1 + m + 1 + 3 * base_count) + _sieve_size + 
+		O_OF_W(priBatchSize(threads) * (m + m - n + 1)) + 
+		sizeof(pri_batch_st) + 
+		threads * (sizeof(pri_worker_st) + sizeof(mt_thrd_t)) +
 		utilMax(4,
 			zzDiv_deep(m, n),
 			zzMul_deep(n, m - n + 1),
-			qr_deep,
-			qrPower_deep(m, m, qr_deep));
+			zzPowerModW_deep(),
+			priDemytko_deep(m, mo));
+}
+
+bool_t priExtendPrime(word p[], size_t l, const word q[], size_t n,
+	size_t trials, size_t base_count, gen_i rng, void* rng_state, void* stack)
+{
+	return priExtendPrimeMT(p, l, q, n, trials, base_count, rng, rng_state, 
+		1, stack);
+}
+
+size_t priExtendPrime_deep(size_t l, size_t n, size_t base_count)
+{
+	return priExtendPrimeMT_deep(l, n, base_count, 1);
 }
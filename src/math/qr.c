@@ -11,6 +11,7 @@ version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
 */
 
+#include <stdarg.h>
 #include "bee2/core/mem.h"
 #include "bee2/core/util.h"
 #include "bee2/math/qr.h"
@@ -183,3 +184,315 @@ size_t qrPower_deep(size_t n, size_t m, size_t r_deep)
 	const size_t powers_count = SIZE_1 << (qrCalcSlideWidth(m) - 1);
 	return O_OF_W(n + n * powers_count) + r_deep;
 }
+
+/*
+*******************************************************************************
+Произведение степеней
+
+В функции qrPowerMulti() реализован метод Штрауса с чередованием скользящих
+окон [Moller B. Algorithms for Multi-exponentiation, SAC 2001]. Для каждого
+a[i] рассчитываются малые степени
+	a[i]^1, a[i]^3,..., a[i]^{2^w[i] - 1},
+где w[i] = qrCalcSlideWidth(m[i]). Затем биты показателей b[i] пробегаются
+одновременно, от старших к младшим. Для каждой позиции выполняется одно
+возведение c в квадрат (общее для всех b[i]). Если в позиции начинается
+слайд b[i], то он запоминается, а в позиции младшего бита слайда c
+умножается на соответствующую малую степень a[i].
+
+Число возведений в квадрат равняется \max_i wwBitSize(b[i], m[i]) вместо
+суммы этих величин при последовательном вызове qrPower().
+*******************************************************************************
+*/
+
+void qrPowerMulti(word c[], const qr_o* r, void* stack, size_t k, ...)
+{
+	size_t i, pos, l_max = 0;
+	bool_t unity;
+	va_list marker;
+	// переменные в stack
+	word* power;		/* текущий результат */
+	word* slide;		/* слайды b[i] */
+	size_t* w;			/* ширина окон */
+	size_t* l;			/* битовые длины b[i] */
+	size_t* low;		/* позиции младших битов слайдов */
+	const word** b;		/* показатели */
+	word** powers;		/* малые степени */
+	// pre
+	ASSERT(qrIsOperable(r));
+	ASSERT(k > 0);
+	ASSERT(wwIsValid(c, r->n));
+	// раскладка stack
+	power = (word*)stack;
+	slide = power + r->n;
+	w = (size_t*)(slide + k);
+	l = w + k;
+	low = l + k;
+	b = (const word**)(low + k);
+	powers = (word**)(b + k);
+	stack = powers + k;
+	// обработать параметры (a[i], b[i], m[i])
+	va_start(marker, k);
+	for (i = 0; i < k; ++i)
+	{
+		const word* a;
+		size_t m, powers_count, j;
+		// a <- a[i], b[i], m <- m[i]
+		a = va_arg(marker, const word*);
+		b[i] = va_arg(marker, const word*);
+		m = va_arg(marker, size_t);
+		ASSERT(wwIsValid(a, r->n));
+		ASSERT(wwIsValid(b[i], m));
+		// размерности
+		w[i] = qrCalcSlideWidth(m);
+		powers_count = SIZE_1 << (w[i] - 1);
+		l[i] = wwBitSize(b[i], m);
+		if (l[i] > l_max)
+			l_max = l[i];
+		low[i] = SIZE_MAX;
+		// резервируем память для powers[i]
+		powers[i] = (word*)stack;
+		stack = powers[i] + r->n * powers_count;
+		// расчет малых степеней a[i]
+		ASSERT(w[i] > 1);
+		qrSqr(powers[i], a, r, stack);
+		qrMul(powers[i] + r->n, a, powers[i], r, stack);
+		for (j = 2; j < powers_count; ++j)
+			qrMul(powers[i] + r->n * j, powers[i] + r->n * j - r->n, 
+				powers[i], r, stack);
+		wwCopy(powers[i], a, r->n);
+	}
+	va_end(marker);
+	// пробегаем биты b[i]
+	unity = TRUE;
+	for (pos = l_max; pos--;)
+	{
+		// power <- power^2
+		if (!unity)
+			qrSqr(power, power, r, stack);
+		// цикл по b[i]
+		for (i = 0; i < k; ++i)
+		{
+			// начинается слайд?
+			if (low[i] == SIZE_MAX && pos < l[i] && wwTestBit(b[i], pos))
+			{
+				size_t slide_size = MIN2(pos + 1, w[i]);
+				slide[i] = wwGetBits(b[i], pos - slide_size + 1, slide_size);
+				while (slide[i] % 2 == 0)
+					slide[i] >>= 1, slide_size--;
+				low[i] = pos - slide_size + 1;
+			}
+			// заканчивается слайд?
+			if (low[i] != pos)
+				continue;
+			// power <- power * powers[i][slide[i] / 2]
+			if (unity)
+				wwCopy(power, powers[i] + r->n * (slide[i] / 2), r->n),
+				unity = FALSE;
+			else
+				qrMul(power, power, powers[i] + r->n * (slide[i] / 2), r, 
+					stack);
+			low[i] = SIZE_MAX;
+		}
+	}
+	// очистка и возврат
+	wwSetZero(slide, k);
+	if (unity)
+		wwCopy(c, r->unity, r->n);
+	else
+		wwCopy(c, power, r->n);
+}
+
+size_t qrPowerMulti_deep(size_t n, size_t r_deep, size_t k, ...)
+{
+	size_t i, ret;
+	va_list marker;
+	ret = O_OF_W(n + k);
+	ret += 3 * sizeof(size_t) * k;
+	ret += 2 * sizeof(word*) * k;
+	va_start(marker, k);
+	for (i = 0; i < k; ++i)
+	{
+		size_t m = va_arg(marker, size_t);
+		ret += O_OF_W(n << (qrCalcSlideWidth(m) - 1));
+	}
+	va_end(marker);
+	ret += r_deep;
+	return ret;
+}
+
+/*
+*******************************************************************************
+Возведение в степень с фиксированным основанием
+
+В функциях qrPowerCombPre(), qrPowerComb() реализован гребенчатый метод
+[Lim C.H., Lee P.J. More Flexible Exponentiation with Precomputation,
+CRYPTO 1994]. Битовая длина l = B_OF_W(m) показателя b разбивается на h
+строк длины d = \lceil l / h \rceil:
+	b = \sum_{i=0}^{h - 1} b_i 2^{i d},	0 <= b_i < 2^d.
+Предварительно рассчитываются элементы
+	pre[j - 1] = \prod_{i: j_i = 1} a^{2^{i d}},	j = 1, 2,..., 2^h - 1,
+где j_i --- i-й бит j. Затем для k = d - 1, d - 2,..., 0 выполняется
+	c <- c^2 * pre[j_k - 1],
+где j_k составлено из k-х битов b_0, b_1,..., b_{h - 1}
+(умножение пропускается при j_k == 0).
+
+Для расчета таблицы требуется (h - 1) d возведений в квадрат и
+2^h - h - 1 умножений. Для расчета c требуется не более d возведений
+в квадрат и d умножений (против l возведений в квадрат в qrPower()).
+
+В функции qrCalcCombWidth() определяется h. Выбор h ограничивает объем
+таблицы: 2^h - 1 элементов кольца.
+*******************************************************************************
+*/
+
+static size_t qrCalcCombWidth(size_t m)
+{
+	m = B_OF_W(m);
+	if (m <= 64)
+		return 4;
+	if (m <= 128)
+		return 5;
+	return 6;
+}
+
+void qrPowerCombPre(word pre[], const word a[], size_t m, const qr_o* r,
+	void* stack)
+{
+	const size_t h = qrCalcCombWidth(m);
+	const size_t d = (B_OF_W(m) + h - 1) / h;
+	size_t i, j, k;
+	// pre
+	ASSERT(qrIsOperable(r));
+	ASSERT(wwIsValid(a, r->n));
+	ASSERT(wwIsValid(pre, r->n * ((SIZE_1 << h) - 1)));
+	// pre[2^i - 1] <- a^{2^{i d}}
+	wwCopy(pre, a, r->n);
+	for (i = 1; i < h; ++i)
+	{
+		word* t = pre + r->n * ((SIZE_1 << i) - 1);
+		wwCopy(t, pre + r->n * ((SIZE_1 << (i - 1)) - 1), r->n);
+		for (k = 0; k < d; ++k)
+			qrSqr(t, t, r, stack);
+	}
+	// pre[j - 1] <- pre[j - 2^i - 1] * pre[2^i - 1], 2^i < j < 2^{i + 1}
+	for (i = 1; i < h; ++i)
+		for (j = (SIZE_1 << i) + 1; j < (SIZE_1 << (i + 1)); ++j)
+			qrMul(pre + r->n * (j - 1),
+				pre + r->n * (j - (SIZE_1 << i) - 1),
+				pre + r->n * ((SIZE_1 << i) - 1), r, stack);
+}
+
+size_t qrPowerCombPre_keep(size_t n, size_t m)
+{
+	return O_OF_W(n * ((SIZE_1 << qrCalcCombWidth(m)) - 1));
+}
+
+size_t qrPowerCombPre_deep(size_t n, size_t m, size_t r_deep)
+{
+	return r_deep;
+}
+
+void qrPowerComb(word c[], const word pre[], const word b[], size_t m,
+	const qr_o* r, void* stack)
+{
+	const size_t l = B_OF_W(m);
+	const size_t h = qrCalcCombWidth(m);
+	const size_t d = (l + h - 1) / h;
+	register size_t j;
+	size_t i, k;
+	bool_t unity;
+	// переменные в stack
+	word* power;
+	// pre
+	ASSERT(qrIsOperable(r));
+	ASSERT(wwIsValid(pre, r->n * ((SIZE_1 << h) - 1)));
+	ASSERT(wwIsValid(b, m));
+	ASSERT(wwIsValid(c, r->n));
+	// раскладка stack
+	power = (word*)stack;
+	stack = power + r->n;
+	// пробегаем столбцы гребенки
+	unity = TRUE;
+	for (k = d; k--;)
+	{
+		// j <- k-е биты строк b
+		for (i = h, j = 0; i--;)
+		{
+			j <<= 1;
+			if (i * d + k < l)
+				j |= wwTestBit(b, i * d + k);
+		}
+		// power <- power^2
+		if (!unity)
+			qrSqr(power, power, r, stack);
+		// power <- power * pre[j - 1]
+		if (j == 0)
+			continue;
+		if (unity)
+			wwCopy(power, pre + r->n * (j - 1), r->n), unity = FALSE;
+		else
+			qrMul(power, power, pre + r->n * (j - 1), r, stack);
+	}
+	// очистка и возврат
+	j = 0;
+	if (unity)
+		wwCopy(c, r->unity, r->n);
+	else
+		wwCopy(c, power, r->n);
+}
+
+size_t qrPowerComb_deep(size_t n, size_t m, size_t r_deep)
+{
+	return O_OF_W(n) + r_deep;
+}
+
+/*
+*******************************************************************************
+Пакетное обращение
+
+Реализован метод Монтгомери. На прямом проходе в b накапливаются 
+произведения префиксов: b[i] <- a[0] a[1] ... a[i]. Затем обращается 
+последнее произведение, и на обратном проходе обратные элементы извлекаются 
+по правилам
+	b[i] <- inv * b[i - 1],
+	inv <- inv * a[i].
+*******************************************************************************
+*/
+
+void qrInvBatch(word b[], const word a[], size_t count, const qr_o* r, 
+	void* stack)
+{
+	size_t i;
+	// переменные в stack
+	word* inv;
+	word* t;
+	// pre
+	ASSERT(qrIsOperable(r));
+	ASSERT(count > 0);
+	ASSERT(wwIsValid(a, count * r->n));
+	ASSERT(wwIsValid(b, count * r->n));
+	ASSERT(wwIsDisjoint(a, b, count * r->n));
+	// раскладка stack
+	inv = (word*)stack;
+	t = inv + r->n;
+	stack = t + r->n;
+	// b[i] <- a[0] a[1] ... a[i]
+	qrCopy(b, a, r);
+	for (i = 1; i < count; ++i)
+		qrMul(b + i * r->n, b + (i - 1) * r->n, a + i * r->n, r, stack);
+	// inv <- (a[0] a[1] ... a[count - 1])^{-1}
+	qrInv(inv, b + (count - 1) * r->n, r, stack);
+	// обратный проход
+	for (i = count - 1; i; --i)
+	{
+		qrMul(t, inv, b + (i - 1) * r->n, r, stack);
+		qrMul(inv, inv, a + i * r->n, r, stack);
+		qrCopy(b + i * r->n, t, r);
+	}
+	qrCopy(b, inv, r);
+}
+
+size_t qrInvBatch_deep(size_t n, size_t r_deep)
+{
+	return O_OF_W(2 * n) + r_deep;
+}
@@ -5,6 +5,8 @@
 
 #include "bee2/math/sd.h"
 #include "bee2/core/mem.h"
+#include "bee2/core/util.h"
+#include "bee2/core/word.h"
 
 
 /****************************************************************************
@@ -112,27 +114,43 @@ bool_t beIsDescendant (u32 a, u32 b)
     return (b == a);
 }
 
+/*****************************************************************************
+Загрузка не более O_PER_W байтов буфера в машинное слово (младший бит 
+слова соответствует младшему биту первого байта).
+*****************************************************************************/
+static word beLoadWord (const u8 *p, u32 len)
+{
+    word w = 0;
+    u32 i;
+    if (len > O_PER_W)
+        len = O_PER_W;
+    for (i = 0; i < len; i++)
+        w |= (word)p[i] << (8 * i);
+    return w;
+}
+
 /*****************************************************************************
 Определение весса Хэмминга буфера (количества листьев), а также номеров первого
-и последнего значащих битов в буфере.
+и последнего значащих битов в буфере. Буфер обрабатывается машинными словами.
 *****************************************************************************/
 u32 beGetCountLeaves (u8 *pBuff, u32 len, u32 *first, u32 *last)
 {
     u32    i, l = 0, w = 0;
     bool_t    b = FALSE;
-    u8    n;
+    word    n;
 
     *first = 0;
-    for (i = 0; i < len; i++) 
+    for (i = 0; i < len; i += O_PER_W) 
     {
-        n = pBuff[i];
-        if (n) /* байт отличен от нуля ?*/
+        n = beLoadWord(pBuff + i, len - i);
+        if (n) /* слово отлично от нуля ?*/
         {
-            w += weight[n]; /* подсчитаем вес Хэмминга*/
-            l = i * 8 + lastleave[n]; /* запомним номер последнего значащего бита */
+            w += (u32)wordWeight(n); /* подсчитаем вес Хэмминга*/
+            /* запомним номер последнего значащего бита */
+            l = i * 8 + (u32)(B_PER_W - 1 - FAST(wordCLZ)(n)); 
             if (!b) 
             {/* установим номер первого значащего бита */
-                *first = i * 8 + firstleave[n];
+                *first = i * 8 + (u32)FAST(wordCTZ)(n);
                 b = TRUE;
             }
         }
@@ -189,43 +207,6 @@ u32 beGetFirstLeave (u8 *T, u32 a, u32 b)
         }
     }
 }
-/*****************************************************************************
-Удаление в дереве T (дерево может быть и неполным) всех листьев,
-которые являются предками вершины u. 
-*****************************************************************************/
-u32 beDelLeaves (u8 h, u8 *T, u32 u)
-{
-    u32 d1, d2, a, b;
-    u8  i, m;
-
-    m = beGetDepth(u);
-    if (m == h) 
-        return ERR_OK;
-    if (m > h) 
-        return ERR_INVALID_PARAMETER;
-    m = h - m;  a = b = u;
-    for (i = 0; i < m; i++) 
-    {/* цикл по уровням */
-        a = a << 1; b = (b << 1) + 1;
-        d1 = a/8, d2 = b/8;
-        if (d1 == d2) /* вершины a и b находятся в одном байте?*/
-            T[d1] &= (((0xFF << (a % 8)) & (0xFF >> (7 - (b % 8)))) ^ 0xFF);
-        else 
-        {
-            T[d1] &= ((0xFF << (a % 8)) ^ 0xFF);
-            if ((d1 + 1) == d2) /* вершины a и b находятся в соседних байтах?*/
-                T[d2] &= ((0xFF >> (7 - (b % 8))) ^ 0xFF); 
-            else
-            {
-                memSet(T + d1 + 1, 0, d2 - d1 - 1);
-                T[d2] &= ((0xFF >> (7 - (b % 8))) ^ 0xFF); 
-            }
-        }
-    }
-    T[u/8] |= (0x01 << (u % 8)); /* установили лист */
-    return ERR_OK;
-}
-
 
 /***************************************************************************
  Построение множества разрешенных листьев по вершине дерева a, которая 
@@ -407,14 +388,99 @@ err_t beCheckLeaf(u8  h,  u32 a,  u32 b,  u32 c)
 /****************************************************************************
 Построение множества индексов, определяющих множество-покрытие для 
 заданного множества запрещенных листьев.
+
+Листья дерева Штейнера хранятся в списке в порядке обхода дерева слева 
+направо. Пара соседних листьев x, y является допустимой, если поддерево 
+с корнем в их общем предке u не содержит других листьев, т.е. соседи 
+x слева и y справа не являются потомками u. Каждый лист входит не более 
+чем в одну допустимую пару, и пара остается допустимой, пока не будет 
+обработана. На каждом шаге обрабатывается допустимая пара с наименьшим 
+номером листа min(x, y) (как и при переборе листьев по возрастанию 
+номеров): пары хранятся в куче по этому ключу. После обработки x и y 
+заменяются на u, и проверяются две новые пары с участием u. Сложность 
+O(r log r) вместо O(r^3) при прямом переборе, результат не меняется.
 ****************************************************************************/
+
+#define BE_NIL ((u32)-1)
+
+/* общий предок вершин x и y */
+static u32 beGetAncestor2 (u32 x, u32 y)
+{
+    u8 dx = beGetDepth(x), dy = beGetDepth(y);
+    word t;
+    if (dx > dy) 
+        x >>= dx - dy;
+    else
+        y >>= dy - dx;
+    t = (word)(x ^ y);
+    if (t)
+        x >>= B_PER_W - FAST(wordCLZ)(t);
+    return x;
+}
+
+typedef struct 
+{
+    u32 *v;        /* вершины-листья дерева Штейнера */
+    u32 *prev;    /* левые соседи */
+    u32 *next;    /* правые соседи */
+    u32 *key;    /* ключи кучи */
+    u32 *pos;    /* левые листья пар в куче */
+    u32 count;    /* число пар в куче */
+} be_cover_st;
+
+/* пара (a, next[a]) является допустимой? */
+static bool_t beIsCoverPair (be_cover_st *st, u32 a)
+{
+    u32 b, u;
+    u8 du;
+    if (a == BE_NIL || (b = st->next[a]) == BE_NIL)
+        return FALSE;
+    u = beGetAncestor2(st->v[a], st->v[b]);
+    du = beGetDepth(u);
+    if (st->prev[a] != BE_NIL &&
+        beGetDepth(beGetAncestor2(st->v[st->prev[a]], st->v[a])) >= du)
+        return FALSE;
+    if (st->next[b] != BE_NIL &&
+        beGetDepth(beGetAncestor2(st->v[b], st->v[st->next[b]])) >= du)
+        return FALSE;
+    return TRUE;
+}
+
+/* добавление пары (a, next[a]) в кучу */
+static void beCoverPush (be_cover_st *st, u32 a)
+{
+    u32 i = st->count++, p, k;
+    k = st->v[a] < st->v[st->next[a]] ? st->v[a] : st->v[st->next[a]];
+    for (; i > 0 && st->key[p = (i - 1) / 2] > k; i = p)
+        st->key[i] = st->key[p], st->pos[i] = st->pos[p];
+    st->key[i] = k, st->pos[i] = a;
+}
+
+/* извлечение пары с наименьшим ключом из кучи */
+static u32 beCoverPop (be_cover_st *st)
+{
+    u32 a = st->pos[0], i = 0, c, k, p;
+    k = st->key[--st->count], p = st->pos[st->count];
+    while ((c = 2 * i + 1) < st->count)
+    {
+        if (c + 1 < st->count && st->key[c + 1] < st->key[c])
+            c++;
+        if (st->key[c] >= k)
+            break;
+        st->key[i] = st->key[c], st->pos[i] = st->pos[c];
+        i = c;
+    }
+    st->key[i] = k, st->pos[i] = p;
+    return a;
+}
+
 err_t beCreateIdsCover(u8 h, u32 *r, u8 *R, u32 *d, u8 *C)
 {
-    u32    s, count, size_leaves, size_tree, size_p, t1, t2, offset = 0;
-    u32    i, j, l, k, u, p; /* номера вершин дерева */
-    u32    e1, e2, e3; /* инкремент в циклах */
-    u8 *pST = NULL; /* указатель на дерево Штейнера */
-    bool_t    flag; /* флаг указывающий, что из дерева удалялись вершины*/  
+    u32    s, count, size_leaves, size_p, t1, t2, offset = 0;
+    u32    i, j, l, k, u, a, b; /* номера вершин дерева */
+    word    w;
+    be_cover_st st[1];
+    u32 *    mem;
     u32  one = 0x00000001;
 
     /* проверим параметры на корректность */
@@ -440,99 +506,90 @@ err_t beCreateIdsCover(u8 h, u32 *r, u8 *R, u32 *d, u8 *C)
         return ERR_OK;
     }
         
-    /* выделим память для дерева Штейнера и построи его */
-    size_tree = BE_SIZE_TREE(h);
-    pST = (u8 *)memAlloc(size_tree);
-    if (pST == NULL) 
+    /* выделим память для списка листьев и кучи */
+    mem = (u32 *)memAlloc(5 * s * sizeof(u32));
+    if (mem == NULL) 
         return ERR_NOT_ENOUGH_MEMORY;
-    memSet(pST, 0 , size_leaves); 
-    memcpy(pST + size_leaves, R, size_leaves);
+    st->v = mem, st->prev = mem + s, st->next = mem + 2 * s;
+    st->key = mem + 3 * s, st->pos = mem + 4 * s;
+    st->count = 0;
 
-    t1 = t1 + (1 << h); /* устанавливаем номер вершины дерева, с которой будем начинать искать лист */
-    t2 = t1 + t2; /* устанавливаем номер вершины дерева, до которой будем искать лист */
-    count = 0; /* инициализируем переменную, отвечающую за количество пар индексов*/
+    /* заполним список запрещенными листьями (по машинным словам) */
+    for (i = 0, j = 0; i < size_leaves; i += O_PER_W)
+        for (w = beLoadWord(R + i, size_leaves - i); w; w &= w - 1)
+        {
+            st->prev[j] = j ? j - 1 : BE_NIL;
+            st->next[j] = j + 1 < s ? j + 1 : BE_NIL;
+            st->v[j++] = (1 << h) + 8 * i + (u32)FAST(wordCTZ)(w);
+        }
+    ASSERT(j == s);
 
+    /* найдем допустимые пары */
+    for (a = 0; a + 1 < s; a++)
+        if (beIsCoverPair(st, a))
+            beCoverPush(st, a);
+
+    count = 0; /* инициализируем переменную, отвечающую за количество пар индексов*/
     while (s > 1)
     {
-        flag = FALSE;
-        i = t1 - 1; /* будем начинать с вершины t1*/
-        for (e1 = 1; e1 < s; e1++) /* пробегаем все листься кроме последнего*/
-        {    
-            i = beGetFirstLeave(pST, i + 1, t2); /* находим первый лист */
-            j = i; /* будем искать начиная с вершины i+1*/
-            for (e2 = e1 + 1; e2 <= s; e2++)
-            {
-                j = beGetFirstLeave(pST, j + 1, t2);    /* находим второй лист */
-                u = beGetAncestor(i, j); /* находим общего предка */
-                p = t1 - 1; /* будем искать начиная с вершины t1*/
-                for (e3 = 1; e3 <= s; e3++)
-                { /* поищем все листья, которые являются потомками u*/
-                    p = beGetFirstLeave(pST, p + 1, t2); 
-                    if ((p == i) | (p == j)) 
-                        continue;
-                    /* проверим, является ли p потомком u*/
-                    if (p) 
-                    {
-                        if ((p >> (beGetDepth(p) - beGetDepth(u))) == u) 
-                            break;
-                    }
-                }
-                if (e3 > s)  /* нет других листьев кроме i и j?*/
-                {    
-                    /* добавляем пары индексов, если выполняются услови (согласно алгоритму) */
-                    l = u << 1; k = l + 1; /* находим сыновей u*/
-                    if ((i >> (beGetDepth(i) - beGetDepth(l))) != l) /* l является предком i?*/
-                    {/* меняем местами l и k */
-                        l ^= k; k ^= l; l ^= k;
-                    }
-                    if (l != i)
-                    {/* добавим пару индексов в выходной буфер*/
-                        count++;
-                        memcpy(C + offset, (u8 *) &l, size_p); 
-                        offset += size_p;
-                        memcpy(C + offset, (u8 *) &i, size_p); 
-                        offset += size_p;
-                    }
-                    if (k != j)
-                    {/* добавим пару индексов в выходной буфер*/
-                        count++;
-                        memcpy(C + offset, (u8 *) &k, size_p); 
-                        offset += size_p;
-                        memcpy(C + offset, (u8 *) &j, size_p); 
-                        offset += size_p;
-                    }
-                    if (beDelLeaves(h, pST, u) != ERR_OK) /* удаляем всех потомков u */
-                    {
-                        memFree(pST);
-                        return ERR_INTERNAL;
-                    } 
-                    flag = TRUE; 
-                    break; /* выходим с цикла*/
-                }
-                if (flag) 
-                    break; /* выходим с цикла*/
-            }
-            if (flag) 
-                break; /* выходим с цикла*/
-        }
-        s = beGetCountLeaves(pST, size_tree, &t1, &t2); /* посчитаем запрещенных пользователей */
-    }
-    if (s == 1) 
-    {/* обработаем особый случай*/
-        p= beGetFirstLeave(pST, t1, t2); 
-        if (p!= 1)
+        if (st->count == 0)
         {
+            memFree(mem);
+            return ERR_INTERNAL;
+        }
+        a = beCoverPop(st);
+        b = st->next[a];
+        i = st->v[a], j = st->v[b];
+        if (i > j)
+        {/* i --- лист с меньшим номером */
+            i ^= j; j ^= i; i ^= j;
+        }
+        u = beGetAncestor2(i, j); /* находим общего предка */
+        /* добавляем пары индексов, если выполняются услови (согласно алгоритму) */
+        l = u << 1; k = l + 1; /* находим сыновей u*/
+        if ((i >> (beGetDepth(i) - beGetDepth(l))) != l) /* l является предком i?*/
+        {/* меняем местами l и k */
+            l ^= k; k ^= l; l ^= k;
+        }
+        if (l != i)
+        {/* добавим пару индексов в выходной буфер*/
             count++;
-            memcpy(C + offset, (u8 *) &one, size_p); 
+            memcpy(C + offset, (u8 *) &l, size_p); 
             offset += size_p;
-            memcpy(C + offset, (u8 *) &p, size_p); 
+            memcpy(C + offset, (u8 *) &i, size_p); 
             offset += size_p;
         }
+        if (k != j)
+        {/* добавим пару индексов в выходной буфер*/
+            count++;
+            memcpy(C + offset, (u8 *) &k, size_p); 
+            offset += size_p;
+            memcpy(C + offset, (u8 *) &j, size_p); 
+            offset += size_p;
+        }
+        /* заменяем листья i и j на u */
+        st->v[a] = u;
+        st->next[a] = st->next[b];
+        if (st->next[b] != BE_NIL)
+            st->prev[st->next[b]] = a;
+        s--;
+        /* проверим новые пары */
+        if (beIsCoverPair(st, st->prev[a]))
+            beCoverPush(st, st->prev[a]);
+        else if (beIsCoverPair(st, a))
+            beCoverPush(st, a);
+    }
+    /* обработаем особый случай: остался один лист */
+    a = 0; /* первый элемент списка никогда не удаляется */
+    if (st->v[a] != 1)
+    {
+        count++;
+        memcpy(C + offset, (u8 *) &one, size_p); 
+        offset += size_p;
+        memcpy(C + offset, (u8 *) &st->v[a], size_p); 
+        offset += size_p;
     }
     *d = count;
-    free(pST);
+    memFree(mem);
     return ERR_OK;
 }
-
-
-
@@ -182,6 +182,10 @@ size_t zmCreatePlain_deep(size_t no)
 /*
 *******************************************************************************
 Кольцо с редукцией Крэндалла
+
+Функция zzRedCrand() полностью редуцирует произвольное число [2n]a. Поэтому
+функции zmMulCrand(), zmSqrCrand() принимают множители в избыточном
+представлении (произвольные числа [n]a) и возвращают вычеты.
 *******************************************************************************
 */
 
@@ -190,8 +194,8 @@ static void zmMulCrand(word c[], const word a[], const word b[],
 {
 	word* prod = (word*)stack;
 	ASSERT(zmIsOperable(r));
-	ASSERT(zmIsIn(a, r));
-	ASSERT(zmIsIn(b, r));
+	ASSERT(wwIsValid(a, r->n));
+	ASSERT(wwIsValid(b, r->n));
 	stack = prod + 2 * r->n;
 	zzMul(prod, a, r->n, b, r->n, stack);
 	zzRedCrand(prod, r->mod, r->n, stack);
@@ -209,7 +213,7 @@ static void zmSqrCrand(word b[], const word a[], const qr_o* r, void* stack)
 {
 	word* prod = (word*)stack;
 	ASSERT(zmIsOperable(r));
-	ASSERT(zmIsIn(a, r));
+	ASSERT(wwIsValid(a, r->n));
 	stack = prod + 2 * r->n;
 	zzSqr(prod, a, r->n, stack);
 	zzRedCrand(prod, r->mod, r->n, stack);
@@ -636,6 +640,12 @@ bool_t zmIsValid(const qr_o* r)
 		r->mod[r->n - 1] != 0;
 }
 
+bool_t zmIsCrand(const qr_o* r)
+{
+	ASSERT(zmIsOperable(r));
+	return r->mul == zmMulCrand && r->sqr == zmSqrCrand;
+}
+
 /*
 *******************************************************************************
 Кольцо Монтгомери
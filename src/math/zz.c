@@ -1620,7 +1620,7 @@ void zzHalfMod(word b[], const word a[], const word mod[], size_t n)
 	ASSERT(zzIsOdd(mod, n) && mod[n - 1] != 0);
 	ASSERT(wwCmp(a, mod, n) < 0);
 	// a -- нечетное? => b <- (a + p) / 2
-	if (wwTestBit(b, 0))
+	if (wwTestBit(a, 0))
 	{
 		carry = zzAdd(b, a, mod, n);
 		while (n--)
@@ -1859,6 +1859,118 @@ size_t zzRedCrand_deep(size_t n)
 	return 0;
 }
 
+/*
+*******************************************************************************
+Избыточное представление Крэндалла
+
+Пусть mod = B^n - c, 0 < c < B^n / 2. Тогда любое число a \in [0, B^n)
+можно рассматривать как (избыточное) представление вычета a \mod mod.
+Вычет имеет не более двух представлений: a и a + mod.
+
+При сложении a + b = s + carry * B^n перенос carry обрабатывается с помощью
+сравнения B^n \equiv c \mod mod: к s добавляется c. Если снова возникает
+перенос, то s < c и повторное добавление c переноса не дает.
+При вычитании заем обрабатывается аналогично.
+
+Функции избыточной арифметики не выполняют сравнений с mod и поэтому
+быстрее своих аналогов zzAddMod(), zzSubMod(), zzNegMod(), zzDoubleMod(), 
+zzHalfMod().
+Полная редукция выполняется функцией zzNormCrand().
+*******************************************************************************
+*/
+
+void zzAddModCrand(word c[], const word a[], const word b[],
+	const word mod[], size_t n)
+{
+	ASSERT(wwIsSameOrDisjoint(a, c, n));
+	ASSERT(wwIsSameOrDisjoint(b, c, n));
+	ASSERT(wwIsDisjoint(c, mod, n));
+	ASSERT(n >= 2 && mod[0] && wwIsRepW(mod + 1, n - 1, WORD_MAX));
+	// a + b >= B^n => a + b - B^n + c
+	if (zzAdd(c, a, b, n) && zzAddW2(c, n, WORD_0 - mod[0]))
+		zzAddW2(c, n, WORD_0 - mod[0]);
+}
+
+void zzSubModCrand(word c[], const word a[], const word b[],
+	const word mod[], size_t n)
+{
+	ASSERT(wwIsSameOrDisjoint(a, c, n));
+	ASSERT(wwIsSameOrDisjoint(b, c, n));
+	ASSERT(wwIsDisjoint(c, mod, n));
+	ASSERT(n >= 2 && mod[0] && wwIsRepW(mod + 1, n - 1, WORD_MAX));
+	// a < b => a - b + B^n - c
+	if (zzSub(c, a, b, n) && zzSubW2(c, n, WORD_0 - mod[0]))
+		zzSubW2(c, n, WORD_0 - mod[0]);
+}
+
+void zzNegModCrand(word b[], const word a[], const word mod[], size_t n)
+{
+	ASSERT(wwIsSameOrDisjoint(a, b, n));
+	ASSERT(wwIsDisjoint(b, mod, n));
+	ASSERT(n >= 2 && mod[0] && wwIsRepW(mod + 1, n - 1, WORD_MAX));
+	// a > mod => mod - a + B^n - c
+	if (zzSub(b, mod, a, n))
+		zzSubW2(b, n, WORD_0 - mod[0]);
+}
+
+void zzDoubleModCrand(word b[], const word a[], const word mod[], size_t n)
+{
+	register word carry = 0;
+	register word hi;
+	size_t i;
+	// pre
+	ASSERT(wwIsSameOrDisjoint(a, b, n));
+	ASSERT(wwIsDisjoint(b, mod, n));
+	ASSERT(n >= 2 && mod[0] && wwIsRepW(mod + 1, n - 1, WORD_MAX));
+	// умножение на 2
+	for (i = 0; i < n; ++i)
+		hi = a[i] >> (B_PER_W - 1),
+		b[i] = a[i] << 1 | carry,
+		carry = hi;
+	// корректировка
+	if (carry && zzAddW2(b, n, WORD_0 - mod[0]))
+		zzAddW2(b, n, WORD_0 - mod[0]);
+	// очистка
+	hi = carry = 0;
+}
+
+void zzHalfModCrand(word b[], const word a[], const word mod[], size_t n)
+{
+	register word carry = 0;
+	register word lo;
+	// pre
+	ASSERT(wwIsSameOrDisjoint(a, b, n));
+	ASSERT(wwIsDisjoint(mod, b, n));
+	ASSERT(n >= 2 && mod[0] && wwIsRepW(mod + 1, n - 1, WORD_MAX));
+	ASSERT(zzIsOdd(mod, n));
+	// a -- нечетное? => b <- (a + mod) / 2 < B^n
+	if (wwTestBit(a, 0))
+	{
+		carry = zzAdd(b, a, mod, n);
+		while (n--)
+			lo = b[n] & 1,
+			b[n] = b[n] >> 1 | carry << (B_PER_W - 1),
+			carry = lo;
+	}
+	// a -- четное? => b <- a / 2
+	else
+		while (n--)
+			lo = a[n] & 1,
+			b[n] = a[n] >> 1 | carry << (B_PER_W - 1),
+			carry = lo;
+	// очистка
+	lo = carry = 0;
+}
+
+void zzNormCrand(word a[], const word mod[], size_t n)
+{
+	ASSERT(wwIsDisjoint(a, mod, n));
+	ASSERT(n >= 2 && mod[0] && wwIsRepW(mod + 1, n - 1, WORD_MAX));
+	// a >= mod => a - mod = a + c - B^n
+	if (wwCmp(a, mod, n) >= 0)
+		zzAddW2(a, n, WORD_0 - mod[0]);
+}
+
 void zzCalcBarrParam(word barr_param[], const word mod[], size_t n, 
 	void* stack)
 {
@@ -2032,6 +2144,51 @@ size_t zzPowerMod_deep(size_t n, size_t m)
 			qrPower_deep(n, m, r_deep));
 }
 
+void zzPowerMod2(word c[], const word a[], const word b[], size_t m, 
+	const word a1[], const word b1[], size_t m1, size_t n, const word mod[], 
+	void* stack)
+{
+	size_t no;
+	// переменные в stack
+	word* t;
+	word* t1;
+	qr_o* r;
+	// pre
+	ASSERT(n > 0 && mod[n - 1] != 0);
+	ASSERT(wwCmp(a, mod, n) < 0);
+	ASSERT(wwCmp(a1, mod, n) < 0);
+	// размерности
+	no = wwOctetSize(mod, n);
+	// раскладка stack
+	t = (word*)stack;
+	t1 = t + n;
+	r = (qr_o*)(t1 + n);
+	stack = (octet*)r + zmCreate_keep(no);
+	// r <- Zm(mod)
+	wwTo(t, no, mod);
+	zmCreate(r, (octet*)t, no, stack);
+	// t <- a, t1 <- a1
+	wwTo(t, no, a);
+	qrFrom(t, (octet*)t, r, stack);
+	wwTo(t1, no, a1);
+	qrFrom(t1, (octet*)t1, r, stack);
+	// t <- t^b t1^b1
+	qrPowerMulti(t, r, stack, 2, t, b, m, t1, b1, m1);
+	// c <- t
+	qrTo((octet*)t, t, r, stack);
+	wwFrom(c, t, no);
+}
+
+size_t zzPowerMod2_deep(size_t n, size_t m, size_t m1)
+{
+	const size_t no = O_OF_W(n);
+	const size_t r_deep = zmCreate_deep(no);
+	return O_OF_W(2 * n) + zmCreate_keep(no) +
+		utilMax(2,
+			r_deep,
+			qrPowerMulti_deep(n, r_deep, 2, m, m1));
+}
+
 /*
 *******************************************************************************
 Возведение в степень по модулю машинного слова
@@ -11,9 +11,146 @@ version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
 */
 
+#include <bee2/core/blob.h>
 #include <bee2/core/mem.h>
+#include <bee2/core/mt.h>
 #include <bee2/core/hex.h>
 #include <bee2/core/str.h>
+#include <bee2/core/util.h>
+
+/*
+*******************************************************************************
+
+
+    :    
+  ,        .
+
+     :   , 
+   ,   ,   
+     .
+*******************************************************************************
+*/
+
+#define MEM_TEST_BLOBS 40000
+
+static bool_t memTestBlobHeavy()
+{
+	bool_t ret = TRUE;
+	blob_stat_t stat;
+	blob_stat_t stat1;
+	blob_t* blobs;
+	size_t i;
+	blobs = (blob_t*)memAlloc(MEM_TEST_BLOBS * sizeof(blob_t));
+	if (!blobs)
+		return FALSE;
+	memSetZero(blobs, MEM_TEST_BLOBS * sizeof(blob_t));
+	blobStat(&stat);
+	for (i = 0; ret && i < MEM_TEST_BLOBS; ++i)
+		if ((blobs[i] = blobCreate(100 + i % 200)) == 0)
+			ret = FALSE;
+		else
+			memCopy(blobs[i], &i, sizeof(i));
+	blobStat(&stat1);
+	if (ret && stat1.mapped - stat.mapped > MEM_TEST_BLOBS / 16)
+		ret = FALSE;
+	for (i = 0; ret && i < MEM_TEST_BLOBS; ++i)
+		if (blobSize(blobs[i]) != 100 + i % 200 ||
+			!memEq(blobs[i], &i, sizeof(i)) ||
+			!memIsZero((octet*)blobs[i] + sizeof(i), 
+				100 + i % 200 - sizeof(i)))
+			ret = FALSE;
+	for (i = 0; i < MEM_TEST_BLOBS; ++i)
+		blobClose(blobs[i]);
+	memFree(blobs);
+	return ret;
+}
+
+typedef struct
+{
+	blob_t blobs[64];		/*<  */
+	bool_t ok;				/*<   */
+} mem_test_blobs_st;
+
+static size_t memTestBlobSize(size_t i)
+{
+	return i % 8 == 7 ? 5000 : 10 + 37 * i;
+}
+
+static bool_t memTestBlobCheck(const mem_test_blobs_st* st)
+{
+	size_t i;
+	for (i = 0; i < COUNT_OF(st->blobs); ++i)
+		if (!st->blobs[i] || 
+			blobSize(st->blobs[i]) != memTestBlobSize(i) ||
+			!memIsRep(st->blobs[i], memTestBlobSize(i), (octet)i))
+			return FALSE;
+	return TRUE;
+}
+
+static void memTestBlobFill(mem_test_blobs_st* st)
+{
+	size_t i;
+	for (i = 0; i < COUNT_OF(st->blobs); ++i)
+		if ((st->blobs[i] = blobCreate(memTestBlobSize(i))) != 0)
+		{
+			if (!memIsZero(st->blobs[i], memTestBlobSize(i)))
+				st->ok = FALSE;
+			memSet(st->blobs[i], (octet)i, memTestBlobSize(i));
+		}
+}
+
+static void memTestBlobClose(mem_test_blobs_st* st)
+{
+	size_t i;
+	for (i = 0; i < COUNT_OF(st->blobs); ++i)
+		blobClose(st->blobs[i]), st->blobs[i] = 0;
+}
+
+static void memTestBlobThread(void* arg)
+{
+	mem_test_blobs_st* st = (mem_test_blobs_st*)arg;
+	//    
+	if (!memTestBlobCheck(st))
+		st->ok = FALSE;
+	memTestBlobClose(st);
+	//     
+	memTestBlobFill(st);
+}
+
+static bool_t memTestBlobThreads()
+{
+	mem_test_blobs_st st[4];
+	mt_thrd_t thrd[COUNT_OF(st)];
+	bool_t created[COUNT_OF(st)];
+	bool_t ret = TRUE;
+	size_t round, i;
+	memSetZero(st, sizeof(st));
+	for (round = 0; round < 3; ++round)
+	{
+		//  
+		for (i = 0; i < COUNT_OF(st); ++i)
+		{
+			st[i].ok = TRUE;
+			memTestBlobFill(st + i);
+		}
+		//    
+		for (i = 0; i < COUNT_OF(st); ++i)
+			created[i] = mtThrdCreate(thrd + i, memTestBlobThread, st + i);
+		for (i = 0; i < COUNT_OF(st); ++i)
+			if (created[i])
+				mtThrdJoin(thrd + i);
+			else
+				memTestBlobThread(st + i);
+		//   
+		for (i = 0; i < COUNT_OF(st); ++i)
+		{
+			if (!st[i].ok || !memTestBlobCheck(st + i))
+				ret = FALSE;
+			memTestBlobClose(st + i);
+		}
+	}
+	return ret;
+}
 
 /*
 *******************************************************************************
@@ -51,6 +188,44 @@ bool_t memTest()
 		memIsRep(buf, 9, 0x01) != TRUE ||
 		memIsRep(buf, 10, 0x01) == TRUE)
 		return FALSE;
+	// 
+	{
+		blob_stat_t stat;
+		blob_stat_t stat1;
+		blob_t blob;
+		blob_t blob1;
+		blobStat(&stat);
+		blob = blobCreate(100);
+		if (!blob || !memIsZero(blob, 100))
+			return FALSE;
+		memSet(blob, 0x5A, 100);
+		if (blobResize(blob, 50) != blob || blobSize(blob) != 50)
+			return FALSE;
+		blob1 = blobResize(blob, 20000);
+		if (!blob1)
+		{
+			blobClose(blob);
+			return FALSE;
+		}
+		if (!memIsRep(blob1, 50, 0x5A) || 
+			!memIsZero((octet*)blob1 + 50, 20000 - 50))
+		{
+			blobClose(blob1);
+			return FALSE;
+		}
+		blobClose(blob1);
+		blob = blobCreate(100);
+		if (!blob || !memIsZero(blob, 100))
+			return FALSE;
+		blobClose(blob);
+		blobStat(&stat1);
+		if (stat1.allocs != stat.allocs + 3 || 
+			stat1.frees != stat.frees + 3 ||
+			stat1.reused == stat.reused)
+			return FALSE;
+	}
+	if (!memTestBlobHeavy() || !memTestBlobThreads())
+		return FALSE;
 	//  
 	return TRUE;
 }
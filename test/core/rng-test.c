@@ -12,18 +12,70 @@ version 3. See Copyright Notices in bee2/info.h.
 */
 
 #include <stdio.h>
+#include <bee2/core/err.h>
 #include <bee2/core/mem.h>
+#include <bee2/core/mt.h>
 #include <bee2/core/hex.h>
 #include <bee2/core/prng.h>
 #include <bee2/core/rng.h>
 #include <bee2/core/util.h>
 
+#if defined OS_UNIX
+	#include <sys/wait.h>
+	#include <unistd.h>
+#endif
+
 /*
 *******************************************************************************
 Тестирование
 *******************************************************************************
 */
 
+static void rngTestThread(void* buf)
+{
+	rngStepG(buf, 32, 0);
+}
+
+/*
+	Буферизованный генератор после fork(): родительский и дочерний процессы 
+	должны получить разные данные, дочерний процесс должен закрыть 
+	генератор без зависания.
+*/
+
+static bool_t rngTestPoolFork(octet buf[64])
+{
+#if defined OS_UNIX
+	int fd[2];
+	int status;
+	pid_t pid;
+	mtSleep(10);
+	if (pipe(fd) != 0)
+		return FALSE;
+	pid = fork();
+	if (pid == 0)
+	{
+		alarm(10);
+		rngPoolStepG(buf, 32, 0);
+		status = write(fd[1], buf, 32) == 32 ? 0 : 1;
+		mtSleep(10);
+		rngPoolStepG(buf, 32, 0);
+		rngPoolClose();
+		rngClose();
+		_exit(status);
+	}
+	close(fd[1]);
+	rngPoolStepG(buf + 32, 32, 0);
+	status = pid > 0 && read(fd[0], buf, 32) == 32;
+	close(fd[0]);
+	if (!status || waitpid(pid, &status, 0) != pid ||
+		!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+		return FALSE;
+	return !memEq(buf, buf + 32, 32);
+#else
+	return TRUE;
+#endif
+}
+
 bool_t rngTest()
 {
 	octet buf[2500];
@@ -83,6 +135,11 @@ bool_t rngTest()
 			hexFrom(hex, buf, read),
 			printf("rngSourceSys:   %s\n", hex);
 	}
+	// проверка работоспособности
+	if (rngTestSource("sys") == ERR_BAD_RNG || 
+		rngTestSource("trng") == ERR_BAD_RNG ||
+		rngTestSource("unknown") != ERR_FILE_NOT_FOUND)
+		return FALSE;
 	// работа с ГСЧ
 	if (rngCreate(0, 0) != ERR_OK)
 		return FALSE;
@@ -94,6 +151,37 @@ bool_t rngTest()
 		rngTestFIPS2(buf) ? '+' : '-',
 		rngTestFIPS3(buf) ? '+' : '-',
 		rngTestFIPS4(buf) ? '+' : '-');
+	// экземпляры потоков
+	{
+		mt_thrd_t thrd;
+		if (mtThrdCreate(&thrd, rngTestThread, buf + 32))
+		{
+			mtThrdJoin(&thrd);
+			rngStepG(buf, 32, 0);
+			if (memEq(buf, buf + 32, 32))
+				return FALSE;
+		}
+	}
+	// пересев при каждом обращении
+	rngSetReseed(0, 1, 0);
+	rngStepG(buf, 32, 0);
+	rngStepG(buf + 32, 32, 0);
+	rngSetReseed(RNG_RESEED_OCTETS, RNG_RESEED_CALLS, RNG_RESEED_SECS);
+	if (memEq(buf, buf + 32, 32))
+		return FALSE;
+	// буферизованный генератор
+	if (rngPoolCreate(1024) != ERR_OK)
+		return FALSE;
+	rngPoolStepG(buf, 2500, 0);
+	mtSleep(10);
+	rngPoolStepG(buf, 32, 0);
+	rngPoolStepG(buf + 32, 32, 0);
+	if (memEq(buf, buf + 32, 32))
+		return FALSE;
+	// буферизованный генератор после fork()
+	if (!rngTestPoolFork(buf))
+		return FALSE;
+	rngPoolClose();
 	rngClose();
 	// все нормально
 	return TRUE;
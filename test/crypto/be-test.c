@@ -11,8 +11,11 @@ version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
 */
 
+#include <bee2/core/hex.h>
 #include <bee2/core/mem.h>
+#include <bee2/core/str.h>
 #include <bee2/crypto/be.h>
+#include <bee2/math/sd.h>
 
 #include <assert.h>
 //#define BREAK break
@@ -26,6 +29,137 @@ version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
 */
 
+/*
+*******************************************************************************
+Тестирование разбора заголовка
+
+Для высоты дерева h и множества запрещенных пользователей R формируется 
+заголовок (X_1, X_2, ...) и проверяется, что пользователи из выборки users 
+(номера от 1 до 2^h) восстанавливают сеансовый ключ тогда и только тогда, 
+когда они не запрещены. Ключи пользователей вычисляются beDeriveUserKeys.
+
+При reverse == TRUE пары индексов в X_1 переставляются в обратном порядке 
+(заголовок старого кодировщика). Двоичный поиск beFindCover в таком 
+списке, как правило, не находит пару, и работает перебор.
+
+Высоты h = 7, 15 (h % 8 == 7) проверяют, что индексы пар читаются 
+BE_SIZE_P(h) байтами, а не BE_SIZE_D(h).
+*******************************************************************************
+*/
+
+static bool_t beTestCover(u8 h, u8 *R, const u32 *users, u32 cnt, 
+    bool_t reverse)
+{
+    bool_t ok = FALSE;
+    u16 const m = 128;
+    u32 const size_d = BE_SIZE_D(h);
+    u32 const size_p = BE_SIZE_P(h);
+    u8 S[16];
+    u8 K[16];
+    u8 KK[16];
+    u8 DK[16];
+    u8 mac[8];
+    u8 tmp[2 * 4]; // 2*size_p
+    beUserKey dkeys[121]; // h*(h+1)/2+1, h <= 15
+    u32 dcount, r, d, E, i, j, u;
+    u8 *BX = NULL;
+    u32 bxsize;
+    u8 *EX = NULL;
+    u32 exsize;
+    err_t err;
+
+    do
+    {
+        memSet( S, 0xaa, sizeof( S ) );
+        memSet( K, 0xbb, sizeof( K ) );
+        // X_1
+        if( ERR_OK != beFormBMsgX( h, R, &r, NULL, &bxsize ) )
+            BREAK;
+        if( NULL == (BX = (u8 *)memAlloc( bxsize )) )
+            BREAK;
+        if( ERR_OK != beFormBMsgX( h, R, &r, BX, &bxsize ) )
+            BREAK;
+        d = 0;
+        memCopy( &d, BX, size_d );
+        // обратный порядок пар
+        if( reverse )
+            for( i = 0, j = d - 1; i < j; ++i, --j )
+            {
+                memCopy( tmp, BX + size_d + 2*i*size_p, 2*size_p );
+                memCopy( BX + size_d + 2*i*size_p, 
+                    BX + size_d + 2*j*size_p, 2*size_p );
+                memCopy( BX + size_d + 2*j*size_p, tmp, 2*size_p );
+            }
+        // X_2, X_3, ...
+        if( ERR_OK != beFormEMsgX( h, m, S, K, r, BX, NULL, &exsize ) )
+            BREAK;
+        if( NULL == (EX = (u8 *)memAlloc( exsize )) )
+            BREAK;
+        if( ERR_OK != beFormEMsgX( h, m, S, K, r, BX, EX, &exsize ) )
+            BREAK;
+        // разбор
+        for( i = 0; i < cnt; ++i )
+        {
+            u = users[i];
+            if( ERR_OK != beDeriveUserKeys( h, m, S, u, NULL, &dcount ) 
+                || dcount > 121 
+                || ERR_OK != beDeriveUserKeys( h, m, S, u, dkeys, &dcount ) )
+                break;
+            err = beAnalyzBMsgX( h, m, u, dkeys, BX, bxsize, &d, &E, DK );
+            if( R[(u - 1) / 8] & (1 << ((u - 1) % 8)) )
+            {
+                if( ERR_REVOKED != err )
+                    break;
+                continue;
+            }
+            if( ERR_OK != err 
+                || ERR_OK != beAnalyzEMsgX( m, EX, exsize, d, E, DK, KK, mac )
+                || ERR_OK != beCheckMsgX( h, m, BX, bxsize, KK, mac )
+                || 0 != memcmp( K, KK, sizeof( K ) ) )
+                break;
+        }
+        if( i < cnt )
+            BREAK;
+        ok = TRUE;
+    } while (0);
+
+    memFree( EX );
+    memFree( BX );
+    return ok;
+}
+
+/*
+*******************************************************************************
+Тестирование покрытия
+
+Для высоты дерева h и множества запрещенных пользователей R строятся 
+покрытие beCreateIdsCover (пары индексов в порядке построения) и X_1 
+(beFormBMsgX, пары отсортированы). Результаты сравниваются с эталонами, 
+полученными прежней реализацией beCreateIdsCover (перебор пар листьев 
+дерева Штейнера).
+*******************************************************************************
+*/
+
+static bool_t beTestCoverKAT(u8 h, u8 *R, const char *C_hex, 
+    const char *X1_hex)
+{
+    u8 C[256];
+    u8 BX[256];
+    u32 r, d, bxsize;
+
+    r = 0;
+    if( ERR_OK != beCreateIdsCover( h, &r, R, &d, C )
+        || strLen( C_hex ) != 4 * d * BE_SIZE_P(h)
+        || !hexEq( C, C_hex ) )
+        return FALSE;
+    bxsize = sizeof( BX );
+    if( ERR_OK != beFormBMsgX( h, R, &r, BX, &bxsize )
+        || strLen( X1_hex ) != 2 * bxsize
+        || !hexEq( BX, X1_hex ) )
+        return FALSE;
+    return TRUE;
+}
+
 bool_t beTest()
 {
     bool_t ok = FALSE;
@@ -37,16 +171,25 @@ bool_t beTest()
     u8 S[32]; // m/8
     // server's precomputed users keys
     beUserKey *akeys = NULL;
+    beUserKey *akeys2 = NULL;
     u32 count;
 
     // all users keys
     beUserKey **ukeys = NULL;
     u32 *ucount = NULL;
     u32 u;
+    // user keys derived on demand
+    beUserKey dkeys[16]; // h*(h+1)/2+1
+    u32 dcount;
+    u32 i;
 
     // revoked set - just int
     u32 R; // max h=5: 2^5=32
     u32 r;
+    // revoked sets for h=7, h=15 and users to check
+    u8 R7[16]; // 2^7/8
+    u8 R15[4096]; // 2^15/8
+    u32 users[128];
 
     // X_1
     u8 *BX;
@@ -65,6 +208,9 @@ bool_t beTest()
     // encrypted data
     u8 *AY;
     u32 aysize;
+    // streaming
+    u8 Y[sizeof(M) + BE_SIZE_IMITO];
+    u8 ystate[1024];
 
     // decryption objects
     // some internal parameters: d, E, DK
@@ -82,6 +228,8 @@ bool_t beTest()
 
     do
     {
+        if( beAMsgY_keep() > sizeof( ystate ) )
+            BREAK;
         // gen server key
         memSet( S, 0xaa, sizeof( S ) );
 
@@ -92,6 +240,17 @@ bool_t beTest()
             BREAK;
         if( ERR_OK != beGenUsersKeys( h, m, S, akeys, &count ) )
             BREAK;
+        // gen users keys in several threads, compare
+        if( NULL == (akeys2 = (beUserKey *) memAlloc( count * sizeof(beUserKey) ) ) )
+            BREAK;
+        if( ERR_OK != beGenUsersKeysMT( h, m, S, akeys2, &count, 3 ) )
+            BREAK;
+        for( i = 0; i < count; ++i )
+            if( akeys[i].a != akeys2[i].a || akeys[i].b != akeys2[i].b
+                || 0 != memcmp( akeys[i].key, akeys2[i].key, m/8 ) )
+                break;
+        if( i < count )
+            BREAK;
 
         if( NULL == (ukeys = (beUserKey **)memAlloc( H * sizeof( beUserKey * ) )) )
             BREAK;
@@ -110,6 +269,25 @@ bool_t beTest()
         if( !(H < u) )
             BREAK;
 
+        // derive user keys without the table, compare
+        for( u = 1; u <= H; ++u )
+        {
+            if( ERR_OK != beDeriveUserKeys( h, m, S, u, NULL, &dcount ) 
+                || dcount != ucount[u-1] || dcount > 16 )
+                BREAK;
+            if( ERR_OK != beDeriveUserKeys( h, m, S, u, dkeys, &dcount ) )
+                BREAK;
+            for( i = 0; i < dcount; ++i )
+                if( dkeys[i].a != ukeys[u-1][i].a
+                    || dkeys[i].b != ukeys[u-1][i].b
+                    || 0 != memcmp( dkeys[i].key, ukeys[u-1][i].key, m/8 ) )
+                    break;
+            if( i < dcount )
+                BREAK;
+        }
+        if( !(H < u) )
+            BREAK;
+
         // for each possible revocation; all users can't be revoked, so (H - 1)
         for( R = 0; R < (H - 1); ++R )
         {
@@ -146,6 +324,42 @@ bool_t beTest()
                     BREAK;
                 if( ERR_OK != beFormAMsgY( m, K, T, M, msize, AY, &aysize ) )
                     BREAK;
+
+                // streaming encryption in chunks must give the same Y
+                memCopy( Y, M, msize );
+                if( ERR_OK != beFormAMsgYStart( ystate, m, K, T ) )
+                    BREAK;
+                beFormAMsgYStep( Y, 2, ystate );
+                beFormAMsgYStep( Y + 2, msize - 2, ystate );
+                beFormAMsgYFinish( Y + msize, ystate );
+                if( aysize != BE_SIZE_SYNHRO + msize + BE_SIZE_IMITO
+                    || 0 != memcmp( AY, T, BE_SIZE_SYNHRO ) 
+                    || 0 != memcmp( AY + BE_SIZE_SYNHRO, Y, msize + BE_SIZE_IMITO ) )
+                    BREAK;
+                // streaming decryption
+                if( ERR_OK != beAnalyzAMsgYStart( ystate, m, K, AY ) )
+                    BREAK;
+                beAnalyzAMsgYStep( Y, 3, ystate );
+                beAnalyzAMsgYStep( Y + 3, msize - 3, ystate );
+                if( ERR_OK != beAnalyzAMsgYFinish( Y + msize, ystate )
+                    || 0 != memcmp( Y, M, msize ) )
+                    BREAK;
+                // ciphertext again: one step
+                memCopy( Y, AY + BE_SIZE_SYNHRO, msize + BE_SIZE_IMITO );
+                if( ERR_OK != beAnalyzAMsgYStart( ystate, m, K, AY ) )
+                    BREAK;
+                beAnalyzAMsgYStep( Y, msize, ystate );
+                if( ERR_OK != beAnalyzAMsgYFinish( Y + msize, ystate )
+                    || 0 != memcmp( Y, M, msize ) )
+                    BREAK;
+                // ciphertext again, corrupted mac
+                memCopy( Y, AY + BE_SIZE_SYNHRO, msize + BE_SIZE_IMITO );
+                Y[msize] ^= 1;
+                if( ERR_OK != beAnalyzAMsgYStart( ystate, m, K, AY ) )
+                    BREAK;
+                beAnalyzAMsgYStep( Y, msize, ystate );
+                if( ERR_BAD_MAC != beAnalyzAMsgYFinish( Y + msize, ystate ) )
+                    BREAK;
             }
 
             // transmit BX[bxsize], EX[exsize], AY[aysize]
@@ -208,6 +422,75 @@ bool_t beTest()
         if( R != (H-1) )
             BREAK;
 
+        // unsorted headers: linear search fallback
+        for( u = 1; u <= H; ++u )
+            users[u-1] = u;
+        for( R = 0; R < (H - 1); ++R )
+            if( !beTestCover( h, (u8 *)&R, users, H, TRUE ) )
+                break;
+        if( R != (H-1) )
+            BREAK;
+
+        // h=7: all users, sorted and unsorted headers
+        memSet( R7, 0, sizeof( R7 ) );
+        R7[(3-1)/8] |= 1 << ((3-1)%8);
+        R7[(50-1)/8] |= 1 << ((50-1)%8);
+        R7[(51-1)/8] |= 1 << ((51-1)%8);
+        R7[(100-1)/8] |= 1 << ((100-1)%8);
+        R7[(128-1)/8] |= 1 << ((128-1)%8);
+        for( u = 1; u <= 128; ++u )
+            users[u-1] = u;
+        if( !beTestCover( 7, R7, users, 128, FALSE )
+            || !beTestCover( 7, R7, users, 128, TRUE ) )
+            BREAK;
+
+        // h=15: revoked users and their neighbours
+        memSet( R15, 0, sizeof( R15 ) );
+        R15[(1-1)/8] |= 1 << ((1-1)%8);
+        R15[(7777-1)/8] |= 1 << ((7777-1)%8);
+        R15[(7778-1)/8] |= 1 << ((7778-1)%8);
+        R15[(20000-1)/8] |= 1 << ((20000-1)%8);
+        R15[(32768-1)/8] |= 1 << ((32768-1)%8);
+        users[0] = 1, users[1] = 2, users[2] = 3;
+        users[3] = 7776, users[4] = 7777, users[5] = 7778, users[6] = 7779;
+        users[7] = 16384, users[8] = 16385;
+        users[9] = 19999, users[10] = 20000, users[11] = 20001;
+        users[12] = 32767, users[13] = 32768;
+        if( !beTestCover( 15, R15, users, 14, FALSE )
+            || !beTestCover( 15, R15, users, 14, TRUE ) )
+            BREAK;
+
+        // known answers: h=7, h=11, h=15
+        if( !beTestCoverKAT( 7, R7,
+            "58B159B2052C04820EE30FFF0307",
+            "070003070482052C0EE30FFF58B159B2" ) )
+            BREAK;
+        memSet( R15, 0, sizeof( R15 ) );
+        for( i = 0; i < 24; ++i )
+            R15[((i*1237 + 5) % 2048)/8] |= 1 << (((i*1237 + 5) % 2048)%8);
+        if( !beTestCoverKAT( 11, R15,
+            "4000050841002E0821005708440080084500A908110022002600AF09"
+            "2700D809090013005000010A51002A0A2900530A5C00820B5D00AB0B"
+            "2F00D40B1600590B0A0014006800030D69002C0D6A00550D6B007E0D"
+            "0D001A000C00DA0C7400840E7500AD0E7600D60E7700FF0E0E001D00"
+            "0F00280F",
+            "1D00090013000A0014000C00DA0C0D001A000E001D000F00280F1100"
+            "22001600590B210057082600AF092700D8092900530A2F00D40B4000"
+            "050841002E08440080084500A9085000010A51002A0A5C00820B5D00"
+            "AB0B6800030D69002C0D6A00550D6B007E0D7400840E7500AD0E7600"
+            "D60E7700FF0E" ) )
+            BREAK;
+        memSet( R15, 0, sizeof( R15 ) );
+        R15[(1-1)/8] |= 1 << ((1-1)%8);
+        R15[(7777-1)/8] |= 1 << ((7777-1)%8);
+        R15[(7778-1)/8] |= 1 << ((7778-1)%8);
+        R15[(20000-1)/8] |= 1 << ((20000-1)%8);
+        R15[(32768-1)/8] |= 1 << ((32768-1)%8);
+        if( !beTestCoverKAT( 15, R15,
+            "0900304F0800008006001FCE0700FFFF02000400",
+            "0500000200040006001FCE0700FFFF080000800900304F" ) )
+            BREAK;
+
         ok = TRUE;
     } while (0);
 
@@ -220,6 +503,7 @@ bool_t beTest()
             memFree( ukeys[u-1] );
     memFree( ukeys ); ukeys = NULL;
     memFree( ucount ); ucount = NULL;
+    memFree( akeys2 ); akeys2 = NULL;
     memFree( akeys ); akeys = NULL;
     return ok;
 }
@@ -11,6 +11,7 @@ version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
 */
 
+#include <bee2/core/err.h>
 #include <bee2/core/mem.h>
 #include <bee2/core/hex.h>
 #include <bee2/core/prng.h>
@@ -35,9 +36,9 @@ bool_t belsTest()
 {
 	size_t len, num;
 	octet m0[32];
-	octet mi[32 * 5];
-	octet s[32];
-	octet si[32 * 5];
+	octet mi[32 * 16];
+	octet s[32 * 3];
+	octet si[32 * 16];
 	char id[] = "Alice";
 	octet echo_state[64];
 	octet combo_state[512];
@@ -276,6 +277,63 @@ bool_t belsTest()
 			"003EEBDF90E803BA37CBA4FF8D9A724F"))
 			return FALSE;
 	}
+	// проверка belsRecover: 16 пользователей, совпадающие ключи
+	for (len = 16; len <= 32; len += 8)
+	{
+		belsStdM(m0, len, 0);
+		for (num = 0; num < 16; ++num)
+			belsStdM(mi + num * len, len, num + 1);
+		if (belsShare(si, 16, 16, len, beltH(), m0, mi, prngCOMBOStepG, 
+				combo_state) != ERR_OK ||
+			belsRecover(s, 16, len, si, m0, mi) != ERR_OK ||
+			!memEq(s, beltH(), len))
+			return FALSE;
+		memCopy(mi + len, mi, len);
+		if (belsRecover(s, 3, len, si, m0, mi) != ERR_BAD_PUBKEY)
+			return FALSE;
+	}
+	// проверка belsRecover: ключ x^l + mi(x) делится на x
+	for (len = 16; len <= 32; len += 8)
+	{
+		belsStdM(m0, len, 0);
+		for (num = 0; num < 3; ++num)
+			belsStdM(mi + num * len, len, num + 1);
+		prngCOMBOStepG(mi + len, len, combo_state);
+		mi[len] &= 0xFE;
+		// один пользователь: s == s1
+		if (belsRecover(s, 1, len, beltH(), m0, mi + len) != ERR_OK ||
+			!memEq(s, beltH(), len))
+			return FALSE;
+		// три пользователя
+		if (belsShare(si, 3, 3, len, beltH(), m0, mi, prngCOMBOStepG, 
+				combo_state) != ERR_OK ||
+			belsRecover(s, 3, len, si, m0, mi) != ERR_OK ||
+			!memEq(s, beltH(), len))
+			return FALSE;
+		// два ключа делятся на x
+		mi[0] &= 0xFE;
+		if (belsRecover(s, 3, len, si, m0, mi) != ERR_BAD_PUBKEY)
+			return FALSE;
+	}
+	// проверка belsShareBatch / belsRecoverBatch
+	for (len = 16; len <= 32; len += 8)
+	{
+		belsStdM(m0, len, 0);
+		for (num = 0; num < 5; ++num)
+			belsStdM(mi + num * len, len, num + 1);
+		memCopy(s, beltH(), 3 * len);
+		if (belsShareBatch(si, 3, 5, 3, len, s, m0, mi, prngCOMBOStepG, 
+				combo_state) != ERR_OK)
+			return FALSE;
+		memSetZero(s, 3 * len);
+		if (belsRecoverBatch(s, 3, 5, len, si, m0, mi) != ERR_OK ||
+			!memEq(s, beltH(), 3 * len))
+			return FALSE;
+		for (num = 0; num < 3; ++num)
+			if (belsRecover(s, 3, len, si + num * 5 * len, m0, mi) != ERR_OK ||
+				!memEq(s, beltH() + num * len, len))
+				return FALSE;
+	}
 	// все нормально
 	return TRUE;
 }
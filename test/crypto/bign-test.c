@@ -11,6 +11,7 @@ version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
 */
 
+#include <bee2/core/err.h>
 #include <bee2/core/mem.h>
 #include <bee2/core/hex.h>
 #include <bee2/core/str.h>
@@ -105,6 +106,8 @@ bool_t bignTest()
 	octet brng_state[1024];
 	octet zz_stack[512];
 	octet token[80];
+	octet xpoints[3 * 33];
+	octet points[3 * 64];
 	word q[W_OF_O(32)];
 	word d[W_OF_O(32)];
 	word H[W_OF_O(32)];
@@ -168,6 +171,26 @@ bool_t bignTest()
 		"7AC6A60361E8C8173491686D461B2826"
 		"190C2EDA5909054A9AB84D2AB9D99A90"))
 		return FALSE;
+	// сжатие точек
+	memSetZero(points, 32);
+	memCopy(points + 32, params->yG, 32);
+	if (bignCompressPoint(xpoints, params, pubkey) != ERR_OK ||
+		bignCompressPoint(xpoints + 33, params, points) != ERR_OK ||
+		bignRecoverPoint(points + 64, params, xpoints) != ERR_OK ||
+		!memEq(points + 64, pubkey, 64))
+		return FALSE;
+	memCopy(xpoints + 66, xpoints, 33);
+	xpoints[98] ^= 1;
+	if (bignRecoverPoints(points, params, 3, xpoints) != ERR_OK ||
+		!memEq(points, pubkey, 64) ||
+		!memIsZero(points + 64, 32) ||
+		!memEq(points + 96, params->yG, 32) ||
+		!memEq(points + 128, pubkey, 32) ||
+		memEq(points + 160, pubkey + 32, 32))
+		return FALSE;
+	xpoints[98] = 2;
+	if (bignRecoverPoints(points, params, 3, xpoints) != ERR_BAD_POINT)
+		return FALSE;
 	// тест Г.2
 	if (beltHash(hash, beltH(), 13) != ERR_OK)
 		return FALSE;
@@ -368,6 +391,14 @@ bool_t bignTest()
 		privkey) != ERR_OK ||
 		!memEq(token, beltH(), 16))
 		return FALSE;
+	// дополнительный тест: транспорт ключа на сжатом открытом ключе
+	if (bignCompressPoint(xpoints, params, pubkey) != ERR_OK ||
+		bignKeyWrapC(token, params, beltH(), 32, 0, xpoints, 
+			brngCTRXStepR, brng_state) != ERR_OK ||
+		bignKeyUnwrap(token, params, token, 32 + 32 + 16, 0, 
+			privkey) != ERR_OK ||
+		!memEq(token, beltH(), 32))
+		return FALSE;
 	// все нормально
 	return TRUE;
 }
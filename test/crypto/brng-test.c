@@ -11,6 +11,7 @@ version 3. See Copyright Notices in bee2/info.h.
 *******************************************************************************
 */
 
+#include <bee2/core/err.h>
 #include <bee2/core/mem.h>
 #include <bee2/core/hex.h>
 #include <bee2/core/util.h>
@@ -38,6 +39,7 @@ bool_t brngTest()
 	octet iv[32];
 	octet iv1[32];
 	octet state[1024];
+	octet mstate[2][2048];
 	// создать стек
 	ASSERT(sizeof(state) >= brngCTR_keep());
 	ASSERT(sizeof(state) >= brngHMAC_keep());
@@ -100,6 +102,30 @@ bool_t brngTest()
 	if (!hexEq(buf, 
 		"42B1"))
 		return FALSE;
+	// многоэкземплярный режим: StepR / Fill
+	ASSERT(sizeof(mstate[0]) >= brngCTRMulti_keep(3));
+	memCopy(buf, beltH(), 256);
+	brngCTRMultiStart(mstate[0], beltH() + 128, beltH() + 128 + 64, 3);
+	brngCTRMultiStepR(buf, 17, mstate[0]);
+	brngCTRMultiStepR(buf + 17, 200, mstate[0]);
+	brngCTRMultiStepR(buf + 217, 39, mstate[0]);
+	memCopy(buf1, beltH(), 256);
+	brngCTRMultiStart(mstate[1], beltH() + 128, beltH() + 128 + 64, 3);
+	if (brngCTRMultiFill(buf1, 17, mstate[1], 2) != ERR_OK ||
+		brngCTRMultiFill(buf1 + 17, 200, mstate[1], 3) != ERR_OK ||
+		brngCTRMultiFill(buf1 + 217, 39, mstate[1], 5) != ERR_OK ||
+		!memEq(buf, buf1, 256))
+		return FALSE;
+	// многоэкземплярный режим: блоки 1 и 4 -- от экземпляра 1
+	memCopy(buf1, beltH() + 128 + 64, 32);
+	memSetZero(buf1 + 32, 4), buf1[32] = 1;
+	beltHash(iv1, buf1, 36);
+	memCopy(buf1, beltH() + 32, 32);
+	memCopy(buf1 + 32, beltH() + 128, 32);
+	brngCTRStart(state, beltH() + 128, iv1);
+	brngCTRStepR(buf1, 64, state);
+	if (!memEq(buf + 32, buf1, 32) || !memEq(buf + 128, buf1 + 32, 32))
+		return FALSE;
 	// все нормально
 	return TRUE;
 }
@@ -46,7 +46,11 @@ bool_t dstuTest()
 	octet pubkey[2 * DSTU_SIZE];
 	octet hash[32];
 	octet sig[2 * DSTU_SIZE];
+	octet points[65 * 2 * 21];
+	octet rpoints[65 * 2 * 21];
+	octet xpoints[65 * 21];
 	size_t ld;
+	size_t i;
 	octet state[512];
 	// тест Б.1 [загрузка параметров]
 	if (dstuStdParams(params, "1.2.804.2.1.1.1.1.3.1.1.1.2.0") != ERR_OK ||
@@ -111,6 +115,18 @@ bool_t dstuTest()
 		dstuVerify(params, ld, hash, 32, sig, pubkey) != ERR_OK ||
 		(sig[0] ^= 1, dstuVerify(params, ld, hash, 32, sig, pubkey) == ERR_OK))
 		return FALSE;
+	// пакетное восстановление точек
+	for (i = 0; i < 65; ++i)
+		if (dstuGenPoint(points + 2 * i * 21, params, prngCOMBOStepG, 
+				state) != ERR_OK ||
+			dstuCompressPoint(xpoints + i * 21, params, 
+				points + 2 * i * 21) != ERR_OK)
+			return FALSE;
+	if (dstuRecoverPoints(rpoints, params, 3, xpoints) != ERR_OK ||
+		!memEq(rpoints, points, 3 * 2 * 21) ||
+		dstuRecoverPoints(rpoints, params, 65, xpoints) != ERR_OK ||
+		!memEq(rpoints, points, sizeof(points)))
+		return FALSE;
 	// проверить кривую dstu_167pb
 	if (dstuStdParams(params, "1.2.804.2.1.1.1.1.3.1.1.1.2.1") != ERR_OK ||
 		dstuGenPoint(params->P, params, prngCOMBOStepG, state) != ERR_OK ||
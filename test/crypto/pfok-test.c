@@ -85,6 +85,7 @@ bool_t pfokTest()
 	octet vb[O_OF_B(638)];
 	octet yb[O_OF_B(638)];
 	octet key[32];
+	word pre[6144 / O_PER_W];
 	// тест PFOK.GENG.1
 	if (pfokStdParams(params, 0, "test") != ERR_OK ||
 		pfokValParams(params) != ERR_OK ||
@@ -120,6 +121,16 @@ bool_t pfokTest()
 		pfokCalcPubkey(yb, params, ua) != ERR_OK ||
 		!memEq(vb, yb, O_OF_B(params->l)))
 		return FALSE;
+	// предвычисления
+	ASSERT(pfokPrecomp_keep(params->l, params->r) <= sizeof(pre));
+	if (pfokPrecomp(pre, params) != ERR_OK ||
+		pfokCalcPubkeyPre(yb, pre, ua) != ERR_OK ||
+		!memEq(vb, yb, O_OF_B(params->l)) ||
+		pfokGenKeypairPre(ua, vb, pre, prngCOMBOStepG, combo_state) != 
+			ERR_OK ||
+		pfokCalcPubkey(yb, params, ua) != ERR_OK ||
+		!memEq(vb, yb, O_OF_B(params->l)))
+		return FALSE;
 	// тест PFOK.ANON.1
 	hexToRev(ua, 
 		"01"
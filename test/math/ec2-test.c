@@ -0,0 +1,198 @@
+/*
+*******************************************************************************
+\file ec2-test.c
+\brief Tests for elliptic curves over binary fields
+\project bee2/test
+\author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
+\created 2026.10.19
+\version 2026.10.19
+\license This program is released under the GNU General Public License
+version 3. See Copyright Notices in bee2/info.h.
+*******************************************************************************
+*/
+
+#include <bee2/core/mem.h>
+#include <bee2/core/prng.h>
+#include <bee2/core/str.h>
+#include <bee2/core/util.h>
+#include <bee2/core/word.h>
+#include <bee2/crypto/dstu.h>
+#include <bee2/math/ec.h>
+#include <bee2/math/ec2.h>
+#include <bee2/math/gf2.h>
+#include <bee2/math/ww.h>
+#include <bee2/math/zz.h>
+
+/*
+*******************************************************************************
+Кратная точка
+
+Кратная точка, рассчитанная с помощью лестницы Монтгомери ec2MulAML()
+(устанавливается в ec->mula функцией ec2CreateLD()), сравнивается с
+кратной точкой, рассчитанной в ecMulA() общим методом (ec->mula == 0).
+
+Используются кривые ДСТУ 4145. Точка a порядка order строится так:
+случайная точка кривой умножается на кофактор. Проверяются кратности
+0, 1, 2, order - 1, order, order + 1 и случайные кратности. Для точки
+порядка 2 (ее x-координата нулевая) общий метод не работает, и кратные
+этой точки сравниваются с ожидаемыми: O или сама точка.
+*******************************************************************************
+*/
+
+static bool_t ec2TestMulACmp(const word a[], ec_o* ec, const word d[],
+	size_t m, void* stack)
+{
+	const size_t n = ec->f->n;
+	ec_mula_i mula = ec->mula;
+	bool_t s, s1;
+	word b[2 * W_OF_B(431)];
+	word b1[2 * W_OF_B(431)];
+	// pre
+	ASSERT(n <= W_OF_B(431));
+	ASSERT(mula != 0);
+	// лестница Монтгомери
+	s = ecMulA(b, a, ec, d, m, stack);
+	// общий метод
+	ec->mula = 0;
+	s1 = ecMulA(b1, a, ec, d, m, stack);
+	ec->mula = mula;
+	// сравнить
+	return s == s1 &&
+		(!s || (wwEq(b, b1, 2 * n) && ec2IsOnA(b, ec, stack)));
+}
+
+static bool_t ec2TestMulA(ec_o* ec, const octet order[], u32 cofactor,
+	octet* combo_state, void* stack)
+{
+	const size_t m = gf2Deg(ec->f);
+	const size_t n = ec->f->n;
+	size_t reps;
+	word a[2 * W_OF_B(431)];
+	word t[W_OF_B(431)];
+	word t2[2 * W_OF_B(431)];
+	word d[W_OF_B(431) + 1];
+	word order_w[W_OF_B(431) + 1];
+	// pre
+	ASSERT(n <= W_OF_B(431));
+	// order_w <- order
+	wwSetZero(order_w, n + 1);
+	wwFrom(order_w, order, ec->f->no);
+	// a <- случайная точка: y^2 + x y == x^3 + A x^2 + B
+	do
+	{
+		prngCOMBOStepG(ecX(a), O_OF_W(n), combo_state);
+		wwTrimHi(ecX(a), n, m);
+		if (qrIsZero(ecX(a), ec->f))
+			continue;
+		qrSqr(t, ecX(a), ec->f, stack);
+		qrMul(ecY(a, n), t, ecX(a), ec->f, stack);
+		qrMul(t, t, ec->A, ec->f, stack);
+		gf2Add2(t, ecY(a, n), ec->f);
+		gf2Add2(t, ec->B, ec->f);
+		wwCopy(d, ecX(a), n);
+	}
+	while (qrIsZero(ecX(a), ec->f) ||
+		!gf2QSolve(ecY(a, n), d, t, ec->f, stack));
+	if (!ec2IsOnA(a, ec, stack))
+		return FALSE;
+	// a <- cofactor a
+	d[0] = (word)cofactor;
+	wwSetZero(d + 1, n);
+	if (!ecMulA(a, a, ec, d, 1, stack))
+		return FALSE;
+	// кратности 0, 1, 2
+	for (d[0] = 0; d[0] < 3; ++d[0])
+		if (!ec2TestMulACmp(a, ec, d, n, stack))
+			return FALSE;
+	// кратности order - 1, order, order + 1
+	wwCopy(d, order_w, n + 1);
+	zzSubW2(d, n + 1, 1);
+	for (reps = 0; reps < 3; ++reps)
+	{
+		if (!ec2TestMulACmp(a, ec, d, n + 1, stack))
+			return FALSE;
+		zzAddW2(d, n + 1, 1);
+	}
+	// случайные кратности
+	for (reps = 0; reps < 10; ++reps)
+	{
+		prngCOMBOStepG(d, O_OF_W(n + 1), combo_state);
+		if (!ec2TestMulACmp(a, ec, d, reps % 2 ? n : n + 1, stack))
+			return FALSE;
+	}
+	// a <- (0, \sqrt(B)) -- точка порядка 2
+	qrSetZero(ecX(a), ec->f);
+	qrCopy(ecY(a, n), ec->B, ec->f);
+	for (reps = 1; reps < m; ++reps)
+		qrSqr(ecY(a, n), ecY(a, n), ec->f, stack);
+	if (!ec2IsOnA(a, ec, stack))
+		return FALSE;
+	wwSetZero(d, n + 1);
+	for (d[0] = 0; d[0] < 4; ++d[0])
+	{
+		if (ecMulA(t2, a, ec, d, n, stack) != (bool_t)(d[0] & 1))
+			return FALSE;
+		if ((d[0] & 1) && !wwEq(t2, a, 2 * n))
+			return FALSE;
+	}
+	return TRUE;
+}
+
+/*
+*******************************************************************************
+Тестирование
+*******************************************************************************
+*/
+
+bool_t ec2Test()
+{
+	bool_t ret = TRUE;
+	char name[] = "1.2.804.2.1.1.1.1.3.1.1.1.2.0";
+	octet combo_state[32];
+	dstu_params params[1];
+	ASSERT(prngCOMBO_keep() <= sizeof(combo_state));
+	prngCOMBOStart(combo_state, utilNonce32());
+	for (; ret && name[strLen(name) - 1] <= '9'; ++name[strLen(name) - 1])
+	{
+		size_t m, n, f_deep, ec_deep, i;
+		size_t p[4];
+		octet A[DSTU_SIZE];
+		qr_o* f;
+		ec_o* ec;
+		void* stack;
+		// загрузить параметры
+		if (dstuStdParams(params, name) != ERR_OK)
+			return FALSE;
+		m = params->p[0];
+		n = W_OF_B(m);
+		f_deep = gf2Create_deep(m);
+		ec_deep = ec2CreateLD_deep(n, f_deep);
+		for (i = 0; i < 4; ++i)
+			p[i] = params->p[i];
+		memSetZero(A, sizeof(A));
+		A[0] = params->A;
+		// выделить память
+		f = (qr_o*)memAlloc(gf2Create_keep(m));
+		ec = (ec_o*)memAlloc(ec2CreateLD_keep(n));
+		stack = memAlloc(utilMax(5,
+			f_deep,
+			ec_deep,
+			gf2QSolve_deep(n, f_deep),
+			ec2IsOnA_deep(n, f_deep),
+			ecMulA_deep(n, 3, ec_deep, n + 1)));
+		if (f == 0 || ec == 0 || stack == 0)
+			ret = FALSE;
+		// создать кривую
+		else if (!gf2Create(f, p, stack) ||
+			!ec2CreateLD(ec, f, A, params->B, stack))
+			ret = FALSE;
+		// проверить кратную точку
+		else
+			ret = ec2TestMulA(ec, params->n, params->c, combo_state, stack);
+		// освободить память
+		memFree(stack);
+		memFree(ec);
+		memFree(f);
+	}
+	return ret;
+}
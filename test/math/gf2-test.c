@@ -0,0 +1,293 @@
+/*
+*******************************************************************************
+\file gf2-test.c
+\brief Tests for binary fields
+\project bee2/test
+\author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
+\created 2026.10.19
+\version 2026.10.19
+\license This program is released under the GNU General Public License
+version 3. See Copyright Notices in bee2/info.h.
+*******************************************************************************
+*/
+
+#include <bee2/core/mem.h>
+#include <bee2/core/prng.h>
+#include <bee2/core/util.h>
+#include <bee2/core/word.h>
+#include <bee2/math/gf2.h>
+#include <bee2/math/pp.h>
+#include <bee2/math/ww.h>
+
+/*
+*******************************************************************************
+Поля
+
+Стандартные поля NIST (FIPS 186) и поля ДСТУ 4145 нечетной степени.
+*******************************************************************************
+*/
+
+static const size_t _fields[][4] =
+{
+	{163, 7, 6, 3},
+	{233, 74, 0, 0},
+	{283, 12, 7, 5},
+	{409, 87, 0, 0},
+	{571, 10, 5, 2},
+	{167, 6, 0, 0},
+	{173, 10, 2, 1},
+	{179, 4, 2, 1},
+	{191, 9, 0, 0},
+	{233, 9, 4, 1},
+	{257, 12, 0, 0},
+	{307, 8, 4, 2},
+	{367, 21, 0, 0},
+	{431, 5, 3, 1},
+};
+
+/*
+*******************************************************************************
+Обращение
+
+Обращение в поле (в полях ДСТУ 4145 -- по алгоритму Ито -- Цудзии) 
+сравнивается с обращением ppInvMod() по модулю многочлена поля. 
+Проверяются также обращение на месте (qrInv(x, x, f)), обращения 1 и 0 
+(обращение 0 дает 0) и деление.
+*******************************************************************************
+*/
+
+static bool_t gf2TestInv(const qr_o* f, octet* combo_state, void* stack)
+{
+	const size_t m = gf2Deg(f);
+	size_t reps;
+	word a[W_OF_B(571)];
+	word b[W_OF_B(571)];
+	word c[W_OF_B(571)];
+	word c1[W_OF_B(571)];
+	// pre
+	ASSERT(f->n <= COUNT_OF(a));
+	ASSERT(m % B_PER_W != 0);
+	// 0^{-1} == 0, 1^{-1} == 1
+	qrSetZero(a, f);
+	qrInv(c, a, f, stack);
+	if (!qrIsZero(c, f))
+		return FALSE;
+	qrSetUnity(a, f);
+	qrInv(c, a, f, stack);
+	if (!qrIsUnity(c, f))
+		return FALSE;
+	for (reps = 0; reps < 20; ++reps)
+	{
+		prngCOMBOStepG(a, O_OF_W(f->n), combo_state);
+		prngCOMBOStepG(b, O_OF_W(f->n), combo_state);
+		wwTrimHi(a, f->n, m);
+		wwTrimHi(b, f->n, m);
+		if (qrIsZero(a, f))
+			continue;
+		// обращение
+		qrInv(c, a, f, stack);
+		ppInvMod(c1, a, f->mod, f->n, stack);
+		if (!wwEq(c, c1, f->n))
+			return FALSE;
+		qrMul(c1, c, a, f, stack);
+		if (!qrIsUnity(c1, f))
+			return FALSE;
+		// обращение на месте
+		qrCopy(c1, a, f);
+		qrInv(c1, c1, f, stack);
+		if (!wwEq(c, c1, f->n))
+			return FALSE;
+		qrMul(c1, c1, a, f, stack);
+		if (!qrIsUnity(c1, f))
+			return FALSE;
+		// деление
+		qrDiv(c1, b, a, f, stack);
+		qrMul(c, b, c, f, stack);
+		if (!wwEq(c, c1, f->n))
+			return FALSE;
+	}
+	return TRUE;
+}
+
+/*
+*******************************************************************************
+Полуслед
+
+Полуслед gf2HTr(), рассчитанный с помощью таблиц, сравнивается с полуследом
+\sum_{i = 0}^{(m - 1) / 2} a^{4^i}, рассчитанным прямо по определению.
+След gf2Tr() сравнивается со следом \sum_{i = 0}^{m - 1} a^{2^i}.
+Решения квадратных уравнений gf2QSolvePre() сравниваются с решениями
+gf2QSolve().
+*******************************************************************************
+*/
+
+static bool_t gf2TestHTr(const qr_o* f, const word pre[], octet* combo_state,
+	void* stack)
+{
+	const size_t m = gf2Deg(f);
+	size_t reps, i;
+	bool_t s, s1;
+	word a[W_OF_B(571)];
+	word b[W_OF_B(571)];
+	word x[W_OF_B(571)];
+	word y[W_OF_B(571)];
+	// pre
+	ASSERT(f->n <= COUNT_OF(a));
+	for (reps = 0; reps < 20; ++reps)
+	{
+		prngCOMBOStepG(a, O_OF_W(f->n), combo_state);
+		wwTrimHi(a, f->n, m);
+		// полуслед
+		gf2HTr(b, a, pre, f, stack);
+		qrCopy(x, a, f), qrCopy(y, a, f);
+		for (i = 0; i < (m - 1) / 2; ++i)
+		{
+			qrSqr(x, x, f, stack);
+			qrSqr(x, x, f, stack);
+			gf2Add2(y, x, f);
+		}
+		if (qrCmp(b, y, f) != 0)
+			return FALSE;
+		// след
+		qrCopy(x, a, f), qrCopy(y, a, f);
+		for (i = 1; i < m; ++i)
+		{
+			qrSqr(x, x, f, stack);
+			gf2Add2(y, x, f);
+		}
+		if ((!qrIsZero(y, f) && !qrIsUnity(y, f)) ||
+			qrIsUnity(y, f) != gf2Tr(a, f, stack))
+			return FALSE;
+		// квадратное уравнение x^2 + a x + b == 0
+		prngCOMBOStepG(b, O_OF_W(f->n), combo_state);
+		wwTrimHi(b, f->n, m);
+		if (reps == 0)
+			qrSetZero(a, f);
+		s = gf2QSolve(x, a, b, f, stack);
+		s1 = gf2QSolvePre(y, a, b, pre, f, stack);
+		if (s != s1)
+			return FALSE;
+		if (!s)
+			continue;
+		if (qrCmp(x, y, f) != 0)
+		{
+			gf2Add2(y, a, f);
+			if (qrCmp(x, y, f) != 0)
+				return FALSE;
+		}
+		qrSqr(y, x, f, stack);
+		qrMul(x, x, a, f, stack);
+		gf2Add2(y, x, f);
+		if (qrCmp(y, b, f) != 0)
+			return FALSE;
+	}
+	return TRUE;
+}
+
+/*
+*******************************************************************************
+Умножение
+
+Умножение и возведение в квадрат в поле (в полях ДСТУ 4145 -- 
+специализированные функции gf2MulXXX(), gf2SqrXXX()) сравниваются с
+умножением многочленов ppMul() и последующим делением с остатком ppMod()
+на многочлен поля.
+*******************************************************************************
+*/
+
+static bool_t gf2TestMul(const qr_o* f, octet* combo_state, void* stack)
+{
+	const size_t m = gf2Deg(f);
+	const size_t n1 = W_OF_B(m + 1);
+	size_t reps;
+	word a[W_OF_B(571)];
+	word b[W_OF_B(571)];
+	word c[W_OF_B(571)];
+	word c1[2 * W_OF_B(571)];
+	// pre
+	ASSERT(f->n <= COUNT_OF(a));
+	for (reps = 0; reps < 100; ++reps)
+	{
+		prngCOMBOStepG(a, O_OF_W(f->n), combo_state);
+		prngCOMBOStepG(b, O_OF_W(f->n), combo_state);
+		// старшие разряды -- единичные
+		if (reps == 0)
+			wwRepW(a, f->n, WORD_MAX), wwRepW(b, f->n, WORD_MAX);
+		wwTrimHi(a, f->n, m);
+		wwTrimHi(b, f->n, m);
+		// умножение
+		qrMul(c, a, b, f, stack);
+		ppMul(c1, a, f->n, b, f->n, stack);
+		ppMod(c1, c1, 2 * f->n, f->mod, n1, stack);
+		if (!wwEq(c, c1, f->n))
+			return FALSE;
+		// возведение в квадрат
+		qrSqr(c, a, f, stack);
+		ppSqr(c1, a, f->n, stack);
+		ppMod(c1, c1, 2 * f->n, f->mod, n1, stack);
+		if (!wwEq(c, c1, f->n))
+			return FALSE;
+	}
+	return TRUE;
+}
+
+/*
+*******************************************************************************
+Тестирование
+*******************************************************************************
+*/
+
+bool_t gf2Test()
+{
+	bool_t ret = TRUE;
+	size_t i;
+	octet combo_state[32];
+	ASSERT(prngCOMBO_keep() <= sizeof(combo_state));
+	prngCOMBOStart(combo_state, utilNonce32());
+	for (i = 0; ret && i < COUNT_OF(_fields); ++i)
+	{
+		const size_t m = _fields[i][0];
+		const size_t n = W_OF_B(m);
+		const size_t f_deep = gf2Create_deep(m);
+		qr_o* f;
+		word* pre;
+		void* stack;
+		// выделить память
+		f = (qr_o*)memAlloc(gf2Create_keep(m));
+		pre = (word*)memAlloc(gf2HTrPre_keep(m));
+		stack = memAlloc(utilMax(11,
+			f_deep,
+			gf2IsValid_deep(n),
+			gf2HTrPre_deep(n, f_deep),
+			gf2HTr_deep(n),
+			ppMul_deep(n, n),
+			ppSqr_deep(n),
+			ppMod_deep(2 * n, n + 1),
+			ppInvMod_deep(n),
+			gf2Tr_deep(n, f_deep),
+			gf2QSolve_deep(n, f_deep),
+			gf2QSolvePre_deep(n, f_deep)));
+		if (f == 0 || pre == 0 || stack == 0)
+			ret = FALSE;
+		// создать поле
+		else if (!gf2Create(f, _fields[i], stack) || !gf2IsValid(f, stack))
+			ret = FALSE;
+		// проверить умножение
+		else if (!gf2TestMul(f, combo_state, stack))
+			ret = FALSE;
+		// проверить обращение
+		else if (!gf2TestInv(f, combo_state, stack))
+			ret = FALSE;
+		// проверить полуслед
+		else
+		{
+			gf2HTrPre(pre, f, stack);
+			ret = gf2TestHTr(f, pre, combo_state, stack);
+		}
+		// освободить память
+		memFree(stack);
+		memFree(pre);
+		memFree(f);
+	}
+	return ret;
+}
@@ -0,0 +1,76 @@
+/*
+*******************************************************************************
+\file pp-test.c
+\brief Tests for binary polynomials
+\project bee2/test
+\author (C) Sergey Agievich [agievich@{bsu.by|gmail.com}]
+\created 2026.10.19
+\version 2026.10.19
+\license This program is released under the GNU General Public License 
+version 3. See Copyright Notices in bee2/info.h.
+*******************************************************************************
+*/
+
+#include <bee2/core/mem.h>
+#include <bee2/core/prng.h>
+#include <bee2/core/util.h>
+#include <bee2/core/word.h>
+#include <bee2/math/pp.h>
+#include <bee2/math/ww.h>
+
+/*
+*******************************************************************************
+Тестирование
+
+Умножение ppMul() (при поддержке PCLMULQDQ -- с помощью этой инструкции) 
+сравнивается с программным умножением на слово ppAddMulW(). Проверяются 
+длины, при которых в ppMul() используются базовые функции (1, 2 слова),
+алгоритм Карацубы над ними (3..9 слов) и общий случай.
+*******************************************************************************
+*/
+
+bool_t ppTest()
+{
+	const size_t n_max = 12;
+	size_t n, m, j, reps;
+	word a[12];
+	word b[12];
+	word c[24];
+	word c1[24];
+	octet combo_state[32];
+	octet stack[4096];
+	// pre
+	ASSERT(COUNT_OF(a) >= n_max);
+	ASSERT(prngCOMBO_keep() <= sizeof(combo_state));
+	ASSERT(ppMul_deep(n_max, n_max) <= sizeof(stack));
+	ASSERT(ppSqr_deep(n_max) <= sizeof(stack));
+	ASSERT(ppAddMulW_deep(n_max) <= sizeof(stack));
+	prngCOMBOStart(combo_state, utilNonce32());
+	for (n = 1; n <= n_max; ++n)
+	for (m = 1; m <= n; ++m)
+	for (reps = 0; reps < 10; ++reps)
+	{
+		prngCOMBOStepG(a, O_OF_W(n), combo_state);
+		prngCOMBOStepG(b, O_OF_W(m), combo_state);
+		if (reps == 0)
+			a[n - 1] = b[m - 1] = WORD_MAX;
+		// c <- a * b
+		ppMul(c, a, n, b, m, stack);
+		// c1 <- \sum_j a * b[j] X^j
+		wwSetZero(c1, n + m);
+		for (j = 0; j < m; ++j)
+			c1[n + j] ^= ppAddMulW(c1 + j, a, n, b[j], stack);
+		if (!wwEq(c, c1, n + m))
+			return FALSE;
+		// квадрат
+		if (m == n)
+		{
+			ppMul(c, a, n, a, n, stack);
+			ppSqr(c1, a, n, stack);
+			if (!wwEq(c, c1, 2 * n))
+				return FALSE;
+		}
+	}
+	// все нормально
+	return TRUE;
+}
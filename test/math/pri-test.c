@@ -29,8 +29,10 @@ bool_t priTest()
 	size_t i;
 	word a[W_OF_B(521)];
 	word p[W_OF_B(289)];
+	word p1[W_OF_B(289)];
 	word mods[1024];
 	octet combo_state[32];
+	octet combo_state1[32];
 	octet stack[4096];
 	// инициализировать генератор COMBO
 	ASSERT(prngCOMBO_keep() <= sizeof(combo_state));
@@ -107,6 +109,15 @@ bool_t priTest()
 	if (!priExtendPrime(p, 289, a, W_OF_B(256), SIZE_MAX, 0, prngCOMBOStepG, 
 		combo_state, stack) || !priIsPrime(p, W_OF_B(289), stack))
 		return FALSE;
+	// построить 289-битовое простое в нескольких потоках
+	ASSERT(priExtendPrimeMT_deep(289, W_OF_B(256), 0, 4) <= sizeof(stack));
+	memCopy(combo_state1, combo_state, sizeof(combo_state));
+	if (!priExtendPrime(p, 289, a, W_OF_B(256), SIZE_MAX, 0, prngCOMBOStepG, 
+		combo_state, stack) ||
+		!priExtendPrimeMT(p1, 289, a, W_OF_B(256), SIZE_MAX, 0, 
+			prngCOMBOStepG, combo_state1, 4, stack) ||
+		!wwEq(p, p1, W_OF_B(289)))
+		return FALSE;
 	// удостовериться, что в интервале (2^256 - 188, 2^256 - 1) нет простых
 	zzAddW2(a, W_OF_B(256), 1);
 	if (priNextPrime(a, a, W_OF_B(256), 200, 0, B_PER_IMPOSSIBLE, stack))
@@ -33,14 +33,16 @@ bool_t zzTest()
 	word c[8];
 	word c1[8];
 	word mod[8];
+	word d[8];
 	octet combo_state[32];
-	octet stack[2048];
+	octet stack[4096];
 	// pre
 	ASSERT(COUNT_OF(a) >= n);
 	ASSERT(COUNT_OF(b) >= n);
 	ASSERT(COUNT_OF(c) >= n);
 	ASSERT(COUNT_OF(c1) >= n);
 	ASSERT(COUNT_OF(mod) >= n);
+	ASSERT(COUNT_OF(d) >= n);
 	// инициализровать генератор COMBO
 	ASSERT(prngCOMBO_keep() <= sizeof(combo_state));
 	prngCOMBOStart(combo_state, utilNonce32());
@@ -57,6 +59,22 @@ bool_t zzTest()
 	zzMulMod(c1, c1, a, mod, n, stack);
 	if (wwCmp(c, c1, n) != 0)
 		return FALSE;
+	// произведение степеней
+	ASSERT(zzPowerMod_deep(n, n / 2) <= sizeof(stack));
+	ASSERT(zzPowerMod2_deep(n, n / 2, n / 4) <= sizeof(stack));
+	for (reps = 0; reps < 10; ++reps)
+	{
+		if (!zzRandMod(a, mod, n, prngCOMBOStepG, combo_state) ||
+			!zzRandMod(b, mod, n, prngCOMBOStepG, combo_state))
+			return FALSE;
+		prngCOMBOStepG(d, O_OF_W(n), combo_state);
+		zzPowerMod(c, a, n, d, n / 2, mod, stack);
+		zzPowerMod(c1, b, n, d + n / 2, n / 4, mod, stack);
+		zzMulMod(c1, c1, c, mod, n, stack);
+		zzPowerMod2(c, a, d, n / 2, b, d + n / 2, n / 4, n, mod, stack);
+		if (!wwEq(c, c1, n))
+			return FALSE;
+	}
 	// сложение / вычитание
 	for (reps = 0; reps < 1000; ++reps)
 	{
@@ -96,6 +114,52 @@ bool_t zzTest()
 			zzIsSumWEq(c, a, 1, b[0]) != wordEq(carry, 0))
 			return FALSE;
 	}
+	// избыточное представление Крэндалла
+	wwRepW(mod, n, WORD_MAX);
+	mod[0] = WORD_0 - 189;
+	for (reps = 0; reps < 1000; ++reps)
+	{
+		word a1[8];
+		word b1[8];
+		prngCOMBOStepG(a, O_OF_W(n), combo_state);
+		prngCOMBOStepG(b, O_OF_W(n), combo_state);
+		if (reps % 2)
+			wwCopy(a, mod, n), zzAddW2(a, n, reps);
+		wwCopy(a1, a, n), zzNormCrand(a1, mod, n);
+		wwCopy(b1, b, n), zzNormCrand(b1, mod, n);
+		if (wwCmp(a1, mod, n) >= 0 || wwCmp(b1, mod, n) >= 0)
+			return FALSE;
+		// zzAddModCrand
+		zzAddModCrand(c, a, b, mod, n);
+		zzNormCrand(c, mod, n);
+		zzAddMod(c1, a1, b1, mod, n);
+		if (!wwEq(c, c1, n))
+			return FALSE;
+		// zzSubModCrand
+		zzSubModCrand(c, a, b, mod, n);
+		zzNormCrand(c, mod, n);
+		zzSubMod(c1, a1, b1, mod, n);
+		if (!wwEq(c, c1, n))
+			return FALSE;
+		// zzNegModCrand
+		zzNegModCrand(c, a, mod, n);
+		zzNormCrand(c, mod, n);
+		zzNegMod(c1, a1, mod, n);
+		if (!wwEq(c, c1, n))
+			return FALSE;
+		// zzDoubleModCrand
+		zzDoubleModCrand(c, a, mod, n);
+		zzNormCrand(c, mod, n);
+		zzDoubleMod(c1, a1, mod, n);
+		if (!wwEq(c, c1, n))
+			return FALSE;
+		// zzHalfModCrand
+		zzHalfModCrand(c, a, mod, n);
+		zzNormCrand(c, mod, n);
+		zzHalfMod(c1, a1, mod, n);
+		if (!wwEq(c, c1, n))
+			return FALSE;
+	}
 	// все нормально
 	return TRUE;
 }
@@ -48,6 +48,9 @@ int testCore()
 *******************************************************************************
 */
 
+extern bool_t ec2Test();
+extern bool_t gf2Test();
+extern bool_t ppTest();
 extern bool_t priTest();
 extern bool_t zzTest();
 extern bool_t wordTest();
@@ -57,6 +60,9 @@ int testMath()
 {
 	bool_t code;
 	int ret = 0;
+	printf("ec2Test: %s\n", (code = ec2Test()) ? "OK" : "Err"), ret |= !code;
+	printf("gf2Test: %s\n", (code = gf2Test()) ? "OK" : "Err"), ret |= !code;
+	printf("ppTest: %s\n", (code = ppTest()) ? "OK" : "Err"), ret |= !code;
 	printf("priTest: %s\n", (code = priTest()) ? "OK" : "Err"), ret |= !code;
 	printf("zzTest: %s\n", (code = zzTest()) ? "OK" : "Err"), ret |= !code;
 	printf("wordTest: %s\n", (code = wordTest()) ? "OK" : "Err"), ret |= !code;